@@ -9,44 +9,264 @@
 #include <limits.h>
 #include <fcntl.h>
 #include <stdbool.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/resource.h>
 
-#define MAX_PROCESSES 1000
-#define MAX_LINE_LENGTH 256
 #define MAX_NAME_LENGTH 51
 #define MAX_DESC_LENGTH 101
-
+#define INITIAL_TABLE_CAPACITY 64
+#define READ_BLOCK_SIZE (1 << 20)
+#define STREAM_BUFFER_SIZE (1 << 16)
+#define ROW_TEXT_SIZE (MAX_NAME_LENGTH + MAX_DESC_LENGTH)
+#define ROW_SKIPPED -2
+#define MLFQ_MAX_LEVELS 16
+#define MLFQ_DEFAULT_BOOST 50
+#define MAX_CORES 1024
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+#define HISTOGRAM_SUB_BITS 4
+#define SWEEP_MAX_QUANTA 1024
+#define TRACE_MAGIC "CPUTRACE"
+#define TRACE_VERSION 1
+#define TRACE_BYTE_ORDER 0x01020304u
+#define HISTOGRAM_BUCKETS (33 << HISTOGRAM_SUB_BITS)
+
+// Process table stored as a structure of arrays: the fields the schedulers scan
+// sit in compact parallel arrays, while names and descriptions live in a
+// separate string arena so they are only touched when a slice is printed.
+typedef struct {
+    int count;
+    int capacity;
+
+    // Hot scheduling fields, indexed by row
+    int *arrival_time;
+    int *burst_time;
+    int *priority;
+    int *remaining_time;
+    int *original_order;
+
+    // Per-run results
+    int *waiting_time;
+    int *completion_time;
+    int *start_time;
+
+    // Row i owns "name\0description\0" starting at text + text_offset[i]
+    size_t *text_offset;
+    char *text;
+    size_t text_used;
+    size_t text_capacity;
+
+    // Row indices sorted by (arrival_time, original_order)
+    int *by_arrival;
+
+    // Binary traces: the input columns above point into this read-only mapping
+    void *mapping;
+    size_t mapping_size;
+
+    // Online mode: rows of finished processes are handed out again, and every
+    // row owns a text slot big enough for the longest name and description
+    bool recycle_rows;
+    int *free_rows;
+    int free_count;
+    int next_order;     // Sequence number of the next process added
+} ProcessTable;
+
+
+// Ring buffer of table rows, doubled when it fills up
 typedef struct {
-    char name[MAX_NAME_LENGTH];
-    char description[MAX_DESC_LENGTH];
-    int arrival_time;
-    int burst_time;
-    int priority;
-    int remaining_time;
-    int waiting_time;
-    int completion_time;
-    int start_time;
-    int original_order;
-} Process;
+    int *data;
+    int capacity;
+    int head, size;
+} Queue;
 
 
+// Clock modes: paced by SIGALRM (every time unit lasts the configured --time-unit)
+// or a virtual clock that jumps straight from one scheduling event to the next
+typedef enum {
+    CLOCK_PACED,
+    CLOCK_VIRTUAL
+} ClockMode;
+
+// Scheduling algorithms, in the order their reports are printed
+typedef enum {
+    ALG_FCFS,
+    ALG_SJF,
+    ALG_PRIORITY,
+    ALG_ROUND_ROBIN,
+    ALG_SRTF,
+    ALG_PREEMPTIVE_PRIORITY,
+    ALG_MLFQ,
+    ALG_LOTTERY,
+    ALG_STRIDE,
+    ALG_COUNT
+} Algorithm;
+
+// Names accepted by --algorithms=
+const char *algorithm_names[ALG_COUNT] = {
+    "fcfs", "sjf", "priority", "rr", "srtf", "preemptive-priority", "mlfq", "lottery", "stride"
+};
+
+// Where the multi-core engine queues a newly arrived process
+typedef enum {
+    PLACE_LEAST_LOADED,
+    PLACE_AFFINITY
+} Placement;
+
+// Report formats: the boxed human report, one CSV record per slice, one JSON
+// object per report, or the human report without its timeline. FORMAT_NONE
+// renders nothing; the quantum sweep uses it to run Round Robin for its numbers.
+typedef enum {
+    FORMAT_HUMAN,
+    FORMAT_CSV,
+    FORMAT_JSON,
+    FORMAT_SUMMARY,
+    FORMAT_NONE
+} OutputFormat;
+
+// What the quantum sweep minimizes when it picks the best quantum
+typedef enum {
+    SWEEP_WAITING,
+    SWEEP_TURNAROUND,
+    SWEEP_SWITCHES
+} SweepMetric;
+
+// Engine settings chosen on the command line
 typedef struct {
-    Process* data[MAX_PROCESSES];
-    int front, rear;
-} Queue;
+    ClockMode clock;
+    long long time_unit_ns;     // Real length of one time unit on the paced clock
+    bool parallel;      // Run every algorithm in its own forked worker
+    Algorithm algorithms[ALG_COUNT];
+    int algorithm_count;
+
+    // Multi-level feedback queue
+    int mlfq_levels;
+    int mlfq_quanta[MLFQ_MAX_LEVELS];   // 0 = derive from the Round Robin quantum
+    int mlfq_boost;                     // Boost period in time units, 0 disables boosting
+
+    // Multi-core simulation, used when cores > 0
+    int cores;
+    Placement placement;
+
+    OutputFormat format;
+    bool metrics;       // Add turnaround, response and waiting percentiles to every summary
+
+    // Round Robin quantum sweep, used instead of the algorithm list when sweep_count > 0
+    int sweep_quanta[SWEEP_MAX_QUANTA];
+    int sweep_count;
+    SweepMetric sweep_metric;
+
+    bool execute;       // Run every process as a real child, stopped and continued at slice boundaries
+    bool online;        // Schedule records as they are read from a stream
+    uint64_t seed;      // Lottery draws; the same seed replays the same schedule
+    bool stats;         // Report the engine's hot-path counters and timings
+} SchedulerOptions;
+
+SchedulerOptions sched_options = {
+    .clock = CLOCK_PACED,
+    .time_unit_ns = 1000000000LL,
+    .parallel = false,
+    .algorithms = { ALG_FCFS, ALG_SJF, ALG_PRIORITY, ALG_ROUND_ROBIN },
+    .algorithm_count = 4,
+    .mlfq_levels = 3,
+    .mlfq_boost = MLFQ_DEFAULT_BOOST,
+    .cores = 0,
+    .placement = PLACE_LEAST_LOADED,
+    .format = FORMAT_HUMAN,
+    .metrics = false,
+    .sweep_count = 0,
+    .sweep_metric = SWEEP_WAITING,
+    .execute = false,
+    .online = false,
+    .seed = 1,
+    .stats = false,
+};
+
+// Reports are rendered into this buffer and handed to write() in one call when
+// a report ends, or earlier if a long timeline fills it up
+char output_buffer[OUTPUT_BUFFER_SIZE];
+size_t output_used = 0;
+
+void flush_output(void) {
+    size_t written = 0;
+    while (written < output_used) {
+        ssize_t w = write(STDOUT_FILENO, output_buffer + written, output_used - written);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0) break;   // Nowhere to write to, drop the output
+        written += w;
+    }
+    output_used = 0;
+}
+
+void output_bytes(const char *s, size_t len) {
+    while (len > OUTPUT_BUFFER_SIZE - output_used) {
+        size_t part = OUTPUT_BUFFER_SIZE - output_used;
+        memcpy(output_buffer + output_used, s, part);
+        output_used += part;
+        s += part;
+        len -= part;
+        flush_output();
+    }
+    memcpy(output_buffer + output_used, s, len);
+    output_used += len;
+}
+
+void output_string(const char *s) {
+    output_bytes(s, strlen(s));
+}
+
+// Integers are formatted by hand, they make up most of a timeline
+void output_int(long long value) {
+    char digits[24];
+    int i = sizeof(digits);
+    unsigned long long u = value < 0 ? -(unsigned long long)value : (unsigned long long)value;
+
+    do {
+        digits[--i] = '0' + u % 10;
+        u /= 10;
+    } while (u);
+    if (value < 0) digits[--i] = '-';
+    output_bytes(digits + i, sizeof(digits) - i);
+}
+
+// printf-style output for the few lines that are not on the hot path
+void output_format(const char *fmt, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
 
+    if (len > 0) output_bytes(line, len < (int)sizeof(line) ? (size_t)len : sizeof(line) - 1);
+}
 
 // Global variables for signal handling
 volatile sig_atomic_t alarm_fired = 0;
 
+// Paced clock: a POSIX timer that raises SIGALRM at absolute deadlines on the
+// monotonic clock. Each wait ends at the previous deadline plus its duration, so
+// the time spent printing and scheduling never adds up into drift.
+timer_t paced_timer;
+pid_t paced_owner = 0;          // Process the timer belongs to, forked workers make their own
+long long paced_deadline_ns;
+sigset_t paced_wait_mask;       // Signal mask while waiting, with SIGALRM unblocked
+
 // Signal handler for alarm
 void alarm_handler(int sig) {
     alarm_fired = 1;
 }
 
-// Function to simulate time passage using signals (required for assignment)
-void simulate_time(int duration) {
-    if (duration <= 0) return;
+long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
 
+// Install the handler and create the timer, once per process
+int init_paced_clock(void) {
     // Set up signal handler using sigaction (satisfies signal requirement)
     struct sigaction sa;
     sa.sa_handler = alarm_handler;
@@ -54,497 +274,2821 @@ void simulate_time(int duration) {
     sa.sa_flags = 0;
     sigaction(SIGALRM, &sa, NULL);
 
+    // SIGALRM stays blocked outside sigsuspend(), so it cannot slip in between
+    // checking alarm_fired and going to sleep
+    sigset_t block;
+    sigemptyset(&block);
+    sigaddset(&block, SIGALRM);
+    sigprocmask(SIG_BLOCK, &block, &paced_wait_mask);
+    sigdelset(&paced_wait_mask, SIGALRM);
+
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo = SIGALRM;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &paced_timer) == -1) {
+        perror("Error creating timer");
+        return 0;
+    }
+
+    paced_owner = getpid();
+    paced_deadline_ns = monotonic_ns();
+    return 1;
+}
+
+// Function to simulate time passage using signals (required for assignment)
+void simulate_time(int duration) {
+    if (duration <= 0) return;
+
+    // The virtual clock is advanced by the schedulers themselves (current_time),
+    // so there is nothing to wait for between events
+    if (sched_options.clock == CLOCK_VIRTUAL) return;
+
+    // Show the slice being waited on
+    flush_output();
+
+    if (paced_owner != getpid() && !init_paced_clock()) exit(1);
+
+    paced_deadline_ns += duration * sched_options.time_unit_ns;
+    struct itimerspec deadline;
+    memset(&deadline, 0, sizeof(deadline));
+    deadline.it_value.tv_sec = paced_deadline_ns / 1000000000LL;
+    deadline.it_value.tv_nsec = paced_deadline_ns % 1000000000LL;
+
     alarm_fired = 0;
-    alarm(duration);
+    timer_settime(paced_timer, TIMER_ABSTIME, &deadline, NULL);
 
     // Wait for alarm signal
     while (!alarm_fired) {
-        pause();
+        sigsuspend(&paced_wait_mask);
+    }
+}
+
+void init_process_table(ProcessTable *t) {
+    memset(t, 0, sizeof(*t));
+}
+
+void free_process_table(ProcessTable *t) {
+    if (t->mapping) {
+        munmap(t->mapping, t->mapping_size);
+    } else {
+        free(t->arrival_time);
+        free(t->burst_time);
+        free(t->priority);
+        free(t->original_order);
+        free(t->text_offset);
+        free(t->text);
+        free(t->by_arrival);
+        free(t->free_rows);
+    }
+    free(t->remaining_time);
+    free(t->waiting_time);
+    free(t->completion_time);
+    free(t->start_time);
+    init_process_table(t);
+}
+
+// Resize one column of the table, returns 0 on allocation failure
+int grow_column(void **column, size_t element_size, int capacity) {
+    void *grown = realloc(*column, element_size * capacity);
+    if (!grown) return 0;
+    *column = grown;
+    return 1;
+}
+
+// Double the row capacity of every column
+int grow_process_table(ProcessTable *t) {
+    int capacity = t->capacity ? t->capacity * 2 : INITIAL_TABLE_CAPACITY;
+
+    if (!grow_column((void **)&t->arrival_time, sizeof(int), capacity) ||
+        !grow_column((void **)&t->burst_time, sizeof(int), capacity) ||
+        !grow_column((void **)&t->priority, sizeof(int), capacity) ||
+        !grow_column((void **)&t->remaining_time, sizeof(int), capacity) ||
+        !grow_column((void **)&t->original_order, sizeof(int), capacity) ||
+        !grow_column((void **)&t->waiting_time, sizeof(int), capacity) ||
+        !grow_column((void **)&t->completion_time, sizeof(int), capacity) ||
+        !grow_column((void **)&t->start_time, sizeof(int), capacity) ||
+        !grow_column((void **)&t->text_offset, sizeof(size_t), capacity) ||
+        (t->recycle_rows && !grow_column((void **)&t->free_rows, sizeof(int), capacity))) {
+        return 0;
+    }
+
+    t->capacity = capacity;
+    return 1;
+}
+
+// Copy len bytes of s into the string arena as a NUL-terminated string
+int append_text(ProcessTable *t, const char *s, size_t len) {
+    if (t->text_used + len + 1 > t->text_capacity) {
+        size_t capacity = t->text_capacity ? t->text_capacity : 4096;
+        while (t->text_used + len + 1 > capacity) capacity *= 2;
+
+        char *grown = realloc(t->text, capacity);
+        if (!grown) return 0;
+        t->text = grown;
+        t->text_capacity = capacity;
+    }
+
+    memcpy(t->text + t->text_used, s, len);
+    t->text[t->text_used + len] = '\0';
+    t->text_used += len + 1;
+    return 1;
+}
+
+// Append a process row, or reuse a released one; name and description are truncated
+// to the assignment limits. Returns the row index, or -1 if memory ran out.
+int add_process(ProcessTable *t, const char *name, size_t name_len, const char *description,
+                size_t desc_len, int arrival_time, int burst_time, int priority) {
+    if (name_len > MAX_NAME_LENGTH - 1) name_len = MAX_NAME_LENGTH - 1;
+    if (desc_len > MAX_DESC_LENGTH - 1) desc_len = MAX_DESC_LENGTH - 1;
+
+    int i;
+    if (t->free_count > 0) {
+        i = t->free_rows[--t->free_count];
+        char *slot = t->text + t->text_offset[i];
+        memcpy(slot, name, name_len);
+        slot[name_len] = '\0';
+        memcpy(slot + name_len + 1, description, desc_len);
+        slot[name_len + 1 + desc_len] = '\0';
+    } else {
+        if (t->count == t->capacity && !grow_process_table(t)) return -1;
+
+        i = t->count;
+        t->text_offset[i] = t->text_used;
+        if (!append_text(t, name, name_len) || !append_text(t, description, desc_len)) return -1;
+
+        // Pad the text to a full slot so any later process fits when the row is reused
+        static const char padding[ROW_TEXT_SIZE];
+        size_t pad = ROW_TEXT_SIZE - (name_len + desc_len + 2);
+        if (t->recycle_rows && pad > 0 && !append_text(t, padding, pad - 1)) return -1;
+        t->count++;
+    }
+
+    t->arrival_time[i] = arrival_time;
+    t->burst_time[i] = burst_time;
+    t->priority[i] = priority;
+    t->remaining_time[i] = burst_time;
+    t->original_order[i] = t->next_order++;
+    t->waiting_time[i] = 0;
+    t->completion_time[i] = 0;
+    t->start_time[i] = -1;
+    return i;
+}
+
+// Hand the row of a finished process back for reuse (tables with recycle_rows only)
+void release_row(ProcessTable *t, int i) {
+    t->free_rows[t->free_count++] = i;
+}
+
+const char *process_name(const ProcessTable *t, int i) {
+    return t->text + t->text_offset[i];
+}
+
+const char *process_description(const ProcessTable *t, int i) {
+    const char *name = process_name(t, i);
+    return name + strlen(name) + 1;
+}
+
+// Parse a whole-field integer such as "12", " 12" or "12\r", returns 0 if the field is not a number
+int parse_int_field(const char *s, size_t len, int *out) {
+    size_t i = 0;
+    while (i < len && (s[i] == ' ' || s[i] == '\t')) i++;
+
+    int sign = 1;
+    if (i < len && (s[i] == '-' || s[i] == '+')) {
+        if (s[i] == '-') sign = -1;
+        i++;
+    }
+
+    size_t digits_start = i;
+    long long value = 0;
+    while (i < len && s[i] >= '0' && s[i] <= '9') {
+        value = value * 10 + (s[i] - '0');
+        if (value > INT_MAX) return 0;
+        i++;
+    }
+    if (i == digits_start) return 0;
+
+    while (i < len && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r')) i++;
+    if (i != len) return 0;
+
+    *out = (int)(sign * value);
+    return 1;
+}
+
+// Parse one CSV row of len bytes (without the newline) into the table. Fields are
+// the non-empty runs between commas, like strtok(). Blank lines and '#' comments
+// are skipped silently; malformed rows are skipped with a warning naming the line.
+// Returns the new row, ROW_SKIPPED for a skipped line, or -1 if memory ran out.
+int parse_csv_record(const char *line, size_t len, long line_no, const char *filename, ProcessTable *t) {
+    const char *field[5];
+    size_t field_len[5];
+    int fields = 0;
+
+    size_t pos = 0;
+    while (pos < len && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r')) pos++;
+    if (pos == len || line[pos] == '#') return ROW_SKIPPED;
+
+    pos = 0;
+    while (pos < len && fields < 5) {
+        const char *comma = memchr(line + pos, ',', len - pos);
+        size_t end = comma ? (size_t)(comma - line) : len;
+
+        if (end > pos) {
+            field[fields] = line + pos;
+            field_len[fields] = end - pos;
+            fields++;
+        }
+        pos = end + 1;
+    }
+
+    // A trailing '\r' from CRLF files belongs to the line ending, not the last field
+    if (fields > 0 && field_len[fields - 1] > 0 && field[fields - 1][field_len[fields - 1] - 1] == '\r') {
+        field_len[fields - 1]--;
+    }
+
+    if (fields < 5) {
+        fprintf(stderr, "Warning: %s:%ld: expected 5 fields, found %d; row skipped\n",
+                filename, line_no, fields);
+        return ROW_SKIPPED;
+    }
+
+    int arrival_time, burst_time, priority;
+    if (!parse_int_field(field[2], field_len[2], &arrival_time) ||
+        !parse_int_field(field[3], field_len[3], &burst_time) ||
+        !parse_int_field(field[4], field_len[4], &priority)) {
+        fprintf(stderr, "Warning: %s:%ld: arrival, burst and priority must be integers; row skipped\n",
+                filename, line_no);
+        return ROW_SKIPPED;
+    }
+
+    return add_process(t, field[0], field_len[0], field[1], field_len[1],
+                       arrival_time, burst_time, priority);
+}
+
+// Parse every complete line in buf. Returns the number of bytes consumed (the
+// start of a trailing partial line, or len if at_eof), or -1 if memory ran out.
+ssize_t parse_csv_buffer(const char *buf, size_t len, bool at_eof, long *line_no,
+                         const char *filename, ProcessTable *t) {
+    size_t pos = 0;
+    while (pos < len) {
+        const char *newline = memchr(buf + pos, '\n', len - pos);
+        if (!newline && !at_eof) break;
+
+        size_t end = newline ? (size_t)(newline - buf) : len;
+        (*line_no)++;
+        if (parse_csv_record(buf + pos, end - pos, *line_no, filename, t) == -1) return -1;
+        pos = newline ? end + 1 : len;
     }
+    return pos;
 }
 
-// Parse CSV line
-int parse_csv_line(char *line, Process *proc, int order) {
-    char *token;
-    char *line_copy = strdup(line);
+// Binary trace file: this header, then the table columns at the given file
+// offsets (each 8-byte aligned) and finally the text arena. Columns hold
+// int32 values and uint64 text offsets in the byte order of the machine that
+// wrote them; byte_order catches files from a machine with another one.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t count;
+    uint64_t arrival_time;
+    uint64_t burst_time;
+    uint64_t priority;
+    uint64_t original_order;
+    uint64_t by_arrival;
+    uint64_t text_offset;
+    uint64_t text;
+    uint64_t text_size;
+} TraceHeader;
+
+// True if a column of `bytes` bytes at `offset` is aligned and lies inside the file
+bool column_fits(uint64_t offset, uint64_t bytes, uint64_t file_size) {
+    return offset % 8 == 0 && offset >= sizeof(TraceHeader) && offset <= file_size &&
+           bytes <= file_size - offset;
+}
 
-    // Remove newline if present
-    line_copy[strcspn(line_copy, "\n")] = 0;
+// True if the arrival order is a permutation of the rows sorted like sort_by_arrival()
+// sorts them, and every row's name and description end inside the text arena. One
+// sequential pass: each entry must come strictly after the previous one by (arrival,
+// input position), which also rules out a row listed twice, so n entries in range
+// are every row once. The arena ends with a NUL, so a description that starts
+// inside it ends inside it too.
+bool trace_rows_valid(const TraceHeader *h, const char *map) {
+    const int32_t *by_arrival = (const int32_t *)(map + h->by_arrival);
+    const int32_t *arrival_time = (const int32_t *)(map + h->arrival_time);
+    const int32_t *original_order = (const int32_t *)(map + h->original_order);
+    const uint64_t *text_offset = (const uint64_t *)(map + h->text_offset);
+    const char *text = map + h->text;
+
+    for (uint64_t i = 0; i < h->count; i++) {
+        int row = by_arrival[i];
+        if (row < 0 || (uint64_t)row >= h->count) return false;
+        if (i > 0) {
+            int prev = by_arrival[i - 1];
+            if (arrival_time[prev] > arrival_time[row] ||
+                (arrival_time[prev] == arrival_time[row] && original_order[prev] >= original_order[row])) {
+                return false;
+            }
+        }
 
-    // Parse name
-    token = strtok(line_copy, ",");
-    if (!token) return 0;
-    strncpy(proc->name, token, MAX_NAME_LENGTH - 1);
-    proc->name[MAX_NAME_LENGTH - 1] = '\0';
+        uint64_t offset = text_offset[i];
+        if (offset >= h->text_size) return false;
+        const char *name_end = memchr(text + offset, '\0', h->text_size - offset);
+        if ((uint64_t)(name_end - text) + 1 >= h->text_size) return false;
+    }
+    return true;
+}
 
-    // Parse description
-    token = strtok(NULL, ",");
-    if (!token) return 0;
-    strncpy(proc->description, token, MAX_DESC_LENGTH - 1);
-    proc->description[MAX_DESC_LENGTH - 1] = '\0';
+// Map a binary trace and point the table's input columns straight into the
+// mapping. Only the per-run result columns are allocated; the rows are checked
+// once, so a damaged file is rejected instead of being read out of bounds.
+int load_binary_trace(int fd, size_t size, const char *filename, ProcessTable *t) {
+    char *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        perror("Error mapping file");
+        return -1;
+    }
 
-    // Parse arrival time
-    token = strtok(NULL, ",");
-    if (!token) return 0;
-    proc->arrival_time = atoi(token);
+    const TraceHeader *h = (const TraceHeader *)map;
+    uint64_t n = h->count;
+    bool valid = sizeof(size_t) == sizeof(uint64_t) &&
+                 h->version == TRACE_VERSION && h->byte_order == TRACE_BYTE_ORDER &&
+                 n > 0 && n <= INT_MAX &&
+                 column_fits(h->arrival_time, n * sizeof(int32_t), size) &&
+                 column_fits(h->burst_time, n * sizeof(int32_t), size) &&
+                 column_fits(h->priority, n * sizeof(int32_t), size) &&
+                 column_fits(h->original_order, n * sizeof(int32_t), size) &&
+                 column_fits(h->by_arrival, n * sizeof(int32_t), size) &&
+                 column_fits(h->text_offset, n * sizeof(uint64_t), size) &&
+                 column_fits(h->text, h->text_size, size) &&
+                 h->text_size > 0 && map[h->text + h->text_size - 1] == '\0' &&
+                 trace_rows_valid(h, map);
+    if (!valid) {
+        fprintf(stderr, "Error: %s is not a valid binary trace\n", filename);
+        munmap(map, size);
+        return -1;
+    }
 
-    // Parse burst time
-    token = strtok(NULL, ",");
-    if (!token) return 0;
-    proc->burst_time = atoi(token);
-    proc->remaining_time = proc->burst_time;
+    t->count = t->capacity = (int)n;
+    t->arrival_time = (int *)(map + h->arrival_time);
+    t->burst_time = (int *)(map + h->burst_time);
+    t->priority = (int *)(map + h->priority);
+    t->original_order = (int *)(map + h->original_order);
+    t->by_arrival = (int *)(map + h->by_arrival);
+    t->text_offset = (size_t *)(map + h->text_offset);
+    t->text = map + h->text;
+    t->text_used = t->text_capacity = h->text_size;
+    t->mapping = map;
+    t->mapping_size = size;
+
+    t->remaining_time = malloc(sizeof(int) * n);
+    t->waiting_time = malloc(sizeof(int) * n);
+    t->completion_time = malloc(sizeof(int) * n);
+    t->start_time = malloc(sizeof(int) * n);
+    if (!t->remaining_time || !t->waiting_time || !t->completion_time || !t->start_time) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return -1;
+    }
+    return t->count;
+}
 
-    // Parse priority
-    token = strtok(NULL, ",");
-    if (!token) return 0;
-    proc->priority = atoi(token);
+// Write a parsed table, including its arrival order, as a binary trace
+int write_binary_trace(const ProcessTable *t, const char *filename) {
+    FILE *out = fopen(filename, "wb");
+    if (!out) {
+        perror("Error opening output file");
+        return 0;
+    }
 
-    proc->original_order = order;
-    proc->waiting_time = 0;
-    proc->completion_time = 0;
-    proc->start_time = -1;
+    uint64_t n = t->count;
+    uint64_t int_column = (n * sizeof(int32_t) + 7) & ~(uint64_t)7;
+    TraceHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRACE_MAGIC, sizeof(h.magic));
+    h.version = TRACE_VERSION;
+    h.byte_order = TRACE_BYTE_ORDER;
+    h.count = n;
+    h.arrival_time = (sizeof(h) + 7) & ~(uint64_t)7;
+    h.burst_time = h.arrival_time + int_column;
+    h.priority = h.burst_time + int_column;
+    h.original_order = h.priority + int_column;
+    h.by_arrival = h.original_order + int_column;
+    h.text_offset = h.by_arrival + int_column;
+    h.text = h.text_offset + n * sizeof(uint64_t);
+    h.text_size = t->text_used;
+
+    static const char padding[8];
+    const int *columns[] = { t->arrival_time, t->burst_time, t->priority, t->original_order, t->by_arrival };
+    bool ok = fwrite(&h, sizeof(h), 1, out) == 1 &&
+              fwrite(padding, 1, h.arrival_time - sizeof(h), out) == h.arrival_time - sizeof(h);
+
+    for (int c = 0; c < 5 && ok; c++) {
+        ok = fwrite(columns[c], sizeof(int32_t), n, out) == n &&
+             fwrite(padding, 1, int_column - n * sizeof(int32_t), out) == int_column - n * sizeof(int32_t);
+    }
+    for (uint64_t i = 0; i < n && ok; i++) {
+        uint64_t offset = t->text_offset[i];
+        ok = fwrite(&offset, sizeof(offset), 1, out) == 1;
+    }
+    ok = ok && fwrite(t->text, 1, t->text_used, out) == t->text_used;
 
-    free(line_copy);
+    if (fclose(out) != 0 || !ok) {
+        perror("Error writing output file");
+        return 0;
+    }
     return 1;
 }
 
-// Read processes from CSV file using low-level system calls
-int read_processes(const char *filename, Process processes[]) {
+// Read processes from a CSV file. Regular files are mapped into memory and parsed
+// in place; anything else (pipes, FIFOs) is read in large blocks.
+int read_processes(const char *filename, ProcessTable *t) {
     int fd = open(filename, O_RDONLY);
     if (fd == -1) {
         perror("Error opening file");
         return -1;
     }
 
-    char line[MAX_LINE_LENGTH];
-    int count = 0;
-    int line_pos = 0;
-    ssize_t bytes_read;
-    char c;
+    long line_no = 0;
+    ssize_t parsed = 0;
+    struct stat st;
+    char magic[sizeof(TRACE_MAGIC) - 1];
+    bool regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+
+    // Binary traces are recognized by their magic, anything else is CSV
+    if (regular && (size_t)st.st_size >= sizeof(TraceHeader) &&
+        pread(fd, magic, sizeof(magic), 0) == (ssize_t)sizeof(magic) &&
+        memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0) {
+        int count = load_binary_trace(fd, st.st_size, filename, t);
+        close(fd);
+        return count;
+    }
 
-    while (count < MAX_PROCESSES) {
-        line_pos = 0;
+    if (regular && st.st_size > 0) {
+        char *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+            parsed = parse_csv_buffer(map, st.st_size, true, &line_no, filename, t);
+            munmap(map, st.st_size);
+            close(fd);
+            if (parsed < 0) {
+                fprintf(stderr, "Error: Out of memory\n");
+                return -1;
+            }
+            return t->count;
+        }
+    }
 
-        // Read line character by character using read()
-        while ((bytes_read = read(fd, &c, 1)) > 0 && c != '\n' && line_pos < MAX_LINE_LENGTH - 1) {
-            line[line_pos++] = c;
+    // Block reads: keep the partial last line at the front of the buffer and
+    // grow the buffer only when a single line does not fit in it
+    size_t capacity = READ_BLOCK_SIZE, used = 0;
+    char *buf = malloc(capacity);
+    int result = -1;
+
+    while (buf) {
+        if (used == capacity) {
+            char *grown = realloc(buf, capacity * 2);
+            if (!grown) {
+                fprintf(stderr, "Error: Out of memory\n");
+                break;
+            }
+            buf = grown;
+            capacity *= 2;
         }
 
-        // End of file reached
-        if (bytes_read <= 0 && line_pos == 0) {
+        ssize_t bytes_read = read(fd, buf + used, capacity - used);
+        if (bytes_read < 0 && errno == EINTR) continue;
+        if (bytes_read < 0) {
+            perror("Error reading file");
             break;
         }
+        used += bytes_read;
 
-        // Null terminate the line
-        line[line_pos] = '\0';
-
-        // Parse the line if it's not empty
-        if (line_pos > 0 && parse_csv_line(line, &processes[count], count)) {
-            count++;
+        parsed = parse_csv_buffer(buf, used, bytes_read == 0, &line_no, filename, t);
+        if (parsed < 0) {
+            fprintf(stderr, "Error: Out of memory\n");
+            break;
         }
+        memmove(buf, buf + parsed, used - parsed);
+        used -= parsed;
 
-        // If we hit EOF, break
-        if (bytes_read <= 0) {
+        if (bytes_read == 0) {
+            result = t->count;
             break;
         }
     }
 
+    if (!buf) fprintf(stderr, "Error: Out of memory\n");
+    free(buf);
     close(fd);
-    return count;
+    return result;
 }
 
-// Comparison functions for sorting
-int compare_fcfs(const void *a, const void *b) {
-    Process *pa = (Process *)a;
-    Process *pb = (Process *)b;
-
-    if (pa->arrival_time != pb->arrival_time)
-        return pa->arrival_time - pb->arrival_time;
-    return pa->original_order - pb->original_order;
+// Comparison functions for ordering two rows of the table
+int compare_fcfs(const ProcessTable *t, int a, int b) {
+    if (t->arrival_time[a] != t->arrival_time[b])
+        return t->arrival_time[a] - t->arrival_time[b];
+    return t->original_order[a] - t->original_order[b];
 }
 
-int compare_sjf(const void *a, const void *b) {
-    Process *pa = (Process *)a;
-    Process *pb = (Process *)b;
+int compare_sjf(const ProcessTable *t, int a, int b) {
+    if (t->burst_time[a] != t->burst_time[b])
+        return t->burst_time[a] - t->burst_time[b];
+    return compare_fcfs(t, a, b);
+}
 
-    if (pa->burst_time != pb->burst_time)
-        return pa->burst_time - pb->burst_time;
-    if (pa->arrival_time != pb->arrival_time)
-        return pa->arrival_time - pb->arrival_time;
-    return pa->original_order - pb->original_order;
+int compare_priority(const ProcessTable *t, int a, int b) {
+    if (t->priority[a] != t->priority[b])
+        return t->priority[a] - t->priority[b];
+    return compare_fcfs(t, a, b);
 }
 
-int compare_priority(const void *a, const void *b) {
-    Process *pa = (Process *)a;
-    Process *pb = (Process *)b;
+// qsort() has no context argument, so the table being sorted is kept here
+const ProcessTable *sort_table;
 
-    if (pa->priority != pb->priority)
-        return pa->priority - pb->priority;
-    if (pa->arrival_time != pb->arrival_time)
-        return pa->arrival_time - pb->arrival_time;
-    return pa->original_order - pb->original_order;
+int compare_fcfs_rows(const void *a, const void *b) {
+    return compare_fcfs(sort_table, *(const int *)a, *(const int *)b);
 }
 
-// FCFS Scheduling
-void schedule_fcfs(Process processes[], int n) {
-    Process temp[MAX_PROCESSES];
-    memcpy(temp, processes, n * sizeof(Process));
-    qsort(temp, n, sizeof(Process), compare_fcfs);
+// Build the arrival-ordered index shared by all schedulers
+int sort_by_arrival(ProcessTable *t) {
+    // A binary trace carries the arrival order it was written with
+    if (t->mapping) return 1;
 
-    printf("══════════════════════════════════════════════\n");
-    printf(">> Scheduler Mode : FCFS\n");
-    printf(">> Engine Status  : Initialized\n");
-    printf("──────────────────────────────────────────────\n\n");
+    free(t->by_arrival);
+    t->by_arrival = malloc(sizeof(int) * (t->count ? t->count : 1));
+    if (!t->by_arrival) return 0;
 
-    int current_time = 0;
-    double total_waiting_time = 0;
+    for (int i = 0; i < t->count; i++) {
+        t->by_arrival[i] = i;
+    }
+    sort_table = t;
+    qsort(t->by_arrival, t->count, sizeof(int), compare_fcfs_rows);
+    return 1;
+}
 
-    for (int i = 0; i < n; i++) {
-        // Handle idle time
-        if (current_time < temp[i].arrival_time) {
-            printf("%d → %d: Idle.\n", current_time, temp[i].arrival_time);
-            simulate_time(temp[i].arrival_time - current_time);
-            current_time = temp[i].arrival_time;
+// Heartbeat of a real child process, in memory shared with the engine
+typedef struct {
+    volatile long long dispatch;    // Bumped by the engine before every SIGCONT
+    volatile long long resumed_ns;  // When the child first ran after the latest dispatch
+} ExecSlot;
+
+// Real processes standing in for the table rows with --execute. Every row gets a
+// CPU-bound child on its first dispatch; the child is continued with SIGCONT when
+// a slice starts and stopped with SIGSTOP (or killed, once its burst is used up)
+// when the next slice or idle period begins.
+typedef struct {
+    ExecSlot *slots;
+    pid_t *pid;                 // 0 before the first dispatch, -1 once reaped
+    int *executed;              // Simulated time units run so far
+    int running;                // Row whose child is continued, -1 if none
+    long long cont_ns;          // When the running child was continued
+    long long switch_ns;        // When the previous child was stopped, -1 after an idle gap
+
+    long long dispatches;
+    long long latency_total_ns, latency_max_ns;
+    long long switches;
+    long long switch_total_ns, switch_max_ns;
+    double cpu_seconds;         // CPU time of the reaped children
+    double burst_seconds;       // Their simulated bursts in real time
+    double min_share;
+    int reaped;
+} Executor;
+
+// Body of a child: spin forever, noting when it gets the CPU after each dispatch
+void run_cpu_bound(ExecSlot *slot) {
+    long long seen = 0;
+    for (;;) {
+        if (slot->dispatch != seen) {
+            slot->resumed_ns = monotonic_ns();
+            seen = slot->dispatch;
         }
+    }
+}
 
-        // Calculate waiting time
-        temp[i].waiting_time = current_time - temp[i].arrival_time;
-        total_waiting_time += temp[i].waiting_time;
+Executor *start_executor(const ProcessTable *t) {
+    Executor *e = calloc(1, sizeof(Executor));
+    if (!e) return NULL;
+
+    e->slots = mmap(NULL, sizeof(ExecSlot) * t->count, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    e->pid = calloc(t->count, sizeof(pid_t));
+    e->executed = calloc(t->count, sizeof(int));
+    if (e->slots == MAP_FAILED || !e->pid || !e->executed) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    e->running = -1;
+    e->switch_ns = -1;
+    e->min_share = -1;
+    return e;
+}
 
-        // Execute process
-        printf("%d → %d: %s Running %s.\n",
-               current_time, current_time + temp[i].burst_time,
-               temp[i].name, temp[i].description);
+// Stop (or reap, if its burst is done) the running child. Returns when it was told
+// to stop, or when it was reaped: tearing down a finished child is not part of a
+// context switch.
+long long stop_running(Executor *e, const ProcessTable *t) {
+    int row = e->running;
+    long long stop_ns = monotonic_ns();
+    long long resumed_ns = e->slots[row].resumed_ns;
+
+    // Dispatch latency: SIGCONT until the child's first heartbeat
+    if (resumed_ns >= e->cont_ns) {
+        long long latency = resumed_ns - e->cont_ns;
+        e->dispatches++;
+        e->latency_total_ns += latency;
+        if (latency > e->latency_max_ns) e->latency_max_ns = latency;
+
+        // Context switch: the previous child was stopped right before this one was continued
+        if (e->switch_ns >= 0) {
+            long long overhead = resumed_ns - e->switch_ns;
+            e->switches++;
+            e->switch_total_ns += overhead;
+            if (overhead > e->switch_max_ns) e->switch_max_ns = overhead;
+        }
+    }
 
-        simulate_time(temp[i].burst_time);
-        current_time += temp[i].burst_time;
-        temp[i].completion_time = current_time;
+    int status;
+    if (e->executed[row] >= t->burst_time[row]) {
+        struct rusage usage;
+        kill(e->pid[row], SIGKILL);
+        if (wait4(e->pid[row], &status, 0, &usage) > 0) {
+            double cpu = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+                         usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+            double burst = t->burst_time[row] * (sched_options.time_unit_ns / 1e9);
+            e->cpu_seconds += cpu;
+            e->burst_seconds += burst;
+            if (e->min_share < 0 || cpu / burst < e->min_share) e->min_share = cpu / burst;
+            e->reaped++;
+        }
+        e->pid[row] = -1;
+        stop_ns = monotonic_ns();
+    } else {
+        kill(e->pid[row], SIGSTOP);
+        waitpid(e->pid[row], &status, WUNTRACED);
     }
 
-    double avg_waiting_time = total_waiting_time / n;
-    printf("\n──────────────────────────────────────────────\n");
-    printf(">> Engine Status  : Completed\n");
-    printf(">> Summary        :\n");
-    printf("   └─ Average Waiting Time : %.2f time units\n", avg_waiting_time);
-    printf(">> End of Report\n");
-    printf("══════════════════════════════════════════════\n\n");
+    e->running = -1;
+    return stop_ns;
 }
 
-// SJF Scheduling (Non-preemptive)
-void schedule_sjf(Process processes[], int n) {
-    Process temp[MAX_PROCESSES];
-    memcpy(temp, processes, n * sizeof(Process));
-
-    printf("══════════════════════════════════════════════\n");
-    printf(">> Scheduler Mode : SJF\n");
-    printf(">> Engine Status  : Initialized\n");
-    printf("──────────────────────────────────────────────\n\n");
-
-    int current_time = 0;
-    double total_waiting_time = 0;
-    int completed = 0;
-    int is_completed[MAX_PROCESSES] = {0};
+// The engine is about to let `row` run for end - start time units (row == -1: idle)
+void execute_slice(Executor *e, const ProcessTable *t, int start, int end, int row) {
+    if (row != -1 && row == e->running) {
+        e->executed[row] += end - start;
+        return;
+    }
 
-    while (completed < n) {
-        int shortest_idx = -1;
-        int shortest_burst = INT_MAX;
-
-        // Find the shortest job among arrived processes
-        for (int i = 0; i < n; i++) {
-            if (!is_completed[i] && temp[i].arrival_time <= current_time) {
-                if (temp[i].burst_time < shortest_burst ||
-                    (temp[i].burst_time == shortest_burst &&
-                     (shortest_idx == -1 || temp[i].arrival_time < temp[shortest_idx].arrival_time ||
-                      (temp[i].arrival_time == temp[shortest_idx].arrival_time &&
-                       temp[i].original_order < temp[shortest_idx].original_order)))) {
-                    shortest_burst = temp[i].burst_time;
-                    shortest_idx = i;
-                }
-            }
+    // Start a first-dispatched child, stopped, before the running one is stopped, so
+    // the fork is not counted as context-switch overhead
+    if (row != -1 && e->pid[row] == 0) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            raise(SIGSTOP);
+            run_cpu_bound(&e->slots[row]);
         }
+        if (pid < 0) {
+            perror("Error starting process");
+            exit(1);
+        }
+        int status;
+        waitpid(pid, &status, WUNTRACED);
+        e->pid[row] = pid;
+    }
 
-        if (shortest_idx == -1) {
-            // No process available, find next arrival
-            int next_arrival = INT_MAX;
-            for (int i = 0; i < n; i++) {
-                if (!is_completed[i] && temp[i].arrival_time > current_time) {
-                    if (temp[i].arrival_time < next_arrival) {
-                        next_arrival = temp[i].arrival_time;
-                    }
-                }
-            }
+    long long stopped_ns = e->running != -1 ? stop_running(e, t) : -1;
+    if (row == -1) return;
 
-            printf("%d → %d: Idle.\n", current_time, next_arrival);
-            simulate_time(next_arrival - current_time);
-            current_time = next_arrival;
-        } else {
-            // Execute the shortest job
-            temp[shortest_idx].waiting_time = current_time - temp[shortest_idx].arrival_time;
-            total_waiting_time += temp[shortest_idx].waiting_time;
+    e->switch_ns = stopped_ns;
+    e->slots[row].dispatch++;
+    e->cont_ns = monotonic_ns();
+    kill(e->pid[row], SIGCONT);
+    e->running = row;
+    e->executed[row] += end - start;
+}
+
+// Streaming histogram with logarithmic buckets: values below 2^HISTOGRAM_SUB_BITS
+// are counted exactly, larger ones in buckets at most 1/16 of their value wide, so
+// percentiles of any trace cost one fixed-size array and no sorting
+typedef struct {
+    long long counts[HISTOGRAM_BUCKETS];
+    long long total;
+    double sum;
+    int max;
+} Histogram;
+
+void histogram_add(Histogram *h, int value) {
+    if (value < 0) value = 0;
+
+    int bucket = value;
+    if (value >= (1 << HISTOGRAM_SUB_BITS)) {
+        int shift = (31 - __builtin_clz(value)) - HISTOGRAM_SUB_BITS;
+        bucket = ((shift + 1) << HISTOGRAM_SUB_BITS) + ((value >> shift) & ((1 << HISTOGRAM_SUB_BITS) - 1));
+    }
 
-            printf("%d → %d: %s Running %s.\n",
-                   current_time, current_time + temp[shortest_idx].burst_time,
-                   temp[shortest_idx].name, temp[shortest_idx].description);
+    h->counts[bucket]++;
+    h->total++;
+    h->sum += value;
+    if (value > h->max) h->max = value;
+}
 
-            simulate_time(temp[shortest_idx].burst_time);
-            current_time += temp[shortest_idx].burst_time;
-            temp[shortest_idx].completion_time = current_time;
-            is_completed[shortest_idx] = 1;
-            completed++;
+// Upper bound of the bucket holding the p-th percentile, capped at the largest value seen
+int histogram_percentile(const Histogram *h, double p) {
+    long long rank = (long long)(p / 100.0 * h->total + 0.999999);
+    if (rank < 1) rank = 1;
+
+    long long seen = 0;
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+        seen += h->counts[bucket];
+        if (seen < rank) continue;
+
+        long long upper = bucket;
+        if (bucket >= (1 << HISTOGRAM_SUB_BITS)) {
+            int shift = (bucket >> HISTOGRAM_SUB_BITS) - 1;
+            long long low = (long long)((bucket & ((1 << HISTOGRAM_SUB_BITS) - 1)) | (1 << HISTOGRAM_SUB_BITS)) << shift;
+            upper = low + (1LL << shift) - 1;
         }
+        return upper < h->max ? (int)upper : h->max;
     }
+    return h->max;
+}
 
-    double avg_waiting_time = total_waiting_time / n;
-    printf("\n──────────────────────────────────────────────\n");
-    printf(">> Engine Status  : Completed\n");
-    printf(">> Summary        :\n");
-    printf("   └─ Average Waiting Time : %.2f time units\n", avg_waiting_time);
-    printf(">> End of Report\n");
-    printf("══════════════════════════════════════════════\n\n");
+// Per-process results gathered as processes finish, for engines that do not
+// keep every row until the end of the run
+typedef struct {
+    Histogram turnaround, response, waiting;
+    long long count;
+    long long busy_time;
+    int makespan;
+} Completions;
+
+void record_completion(Completions *c, const ProcessTable *t, int i) {
+    histogram_add(&c->turnaround, t->completion_time[i] - t->arrival_time[i]);
+    histogram_add(&c->response, t->start_time[i] - t->arrival_time[i]);
+    histogram_add(&c->waiting, t->waiting_time[i]);
+    c->count++;
+    c->busy_time += t->burst_time[i];
+    if (t->completion_time[i] > c->makespan) c->makespan = t->completion_time[i];
 }
 
-// Priority Scheduling (Non-preemptive)
-void schedule_priority(Process processes[], int n) {
-    Process temp[MAX_PROCESSES];
-    memcpy(temp, processes, n * sizeof(Process));
+// Engine phases timed by --stats
+typedef enum {
+    STATS_SELECT,   // Policy callbacks: admitting, picking and requeueing processes
+    STATS_OUTPUT,   // Rendering slices
+    STATS_PHASES
+} StatsPhase;
 
-    printf("══════════════════════════════════════════════\n");
-    printf(">> Scheduler Mode : Priority\n");
-    printf(">> Engine Status  : Initialized\n");
-    printf("──────────────────────────────────────────────\n\n");
+// What --stats collects besides the Report's own counters. Without --stats no
+// EngineStats exists and the engine takes no timestamps at all.
+typedef struct {
+    Histogram ready_length;     // Processes left waiting at each dispatch
+    long long ns[STATS_PHASES];
+    long long mark;             // Start of the phase being timed
+    bool timed;                 // Filled by run_policy; the multi-core engine only has the counters
+} EngineStats;
 
-    int current_time = 0;
-    double total_waiting_time = 0;
-    int completed = 0;
-    int is_completed[MAX_PROCESSES] = {0};
+long long parse_ns;     // Reading and parsing the input, for --stats
 
-    while (completed < n) {
-        int highest_priority_idx = -1;
-        int highest_priority = INT_MAX;
-
-        // Find the highest priority job among arrived processes
-        for (int i = 0; i < n; i++) {
-            if (!is_completed[i] && temp[i].arrival_time <= current_time) {
-                if (temp[i].priority < highest_priority ||
-                    (temp[i].priority == highest_priority &&
-                     (highest_priority_idx == -1 || temp[i].arrival_time < temp[highest_priority_idx].arrival_time ||
-                      (temp[i].arrival_time == temp[highest_priority_idx].arrival_time &&
-                       temp[i].original_order < temp[highest_priority_idx].original_order)))) {
-                    highest_priority = temp[i].priority;
-                    highest_priority_idx = i;
-                }
-            }
-        }
+void stats_start(EngineStats *s) {
+    if (s) s->mark = monotonic_ns();
+}
 
-        if (highest_priority_idx == -1) {
-            // No process available, find next arrival
-            int next_arrival = INT_MAX;
-            for (int i = 0; i < n; i++) {
-                if (!is_completed[i] && temp[i].arrival_time > current_time) {
-                    if (temp[i].arrival_time < next_arrival) {
-                        next_arrival = temp[i].arrival_time;
-                    }
-                }
-            }
+// Charge the time since the last mark to a phase and start timing the next one
+void stats_lap(EngineStats *s, StatsPhase phase) {
+    if (!s) return;
+    long long now = monotonic_ns();
+    s->ns[phase] += now - s->mark;
+    s->mark = now;
+}
 
-            printf("%d → %d: Idle.\n", current_time, next_arrival);
-            simulate_time(next_arrival - current_time);
-            current_time = next_arrival;
-        } else {
-            // Execute the highest priority job
-            temp[highest_priority_idx].waiting_time = current_time - temp[highest_priority_idx].arrival_time;
-            total_waiting_time += temp[highest_priority_idx].waiting_time;
+// One line of a report summary. The JSON key is derived from the label.
+typedef struct {
+    char label[40];
+    char value[32];
+    char unit[24];      // Printed after the value in the human format, e.g. " time units"
+} SummaryItem;
 
-            printf("%d → %d: %s Running %s.\n",
-                   current_time, current_time + temp[highest_priority_idx].burst_time,
-                   temp[highest_priority_idx].name, temp[highest_priority_idx].description);
+// A scheduler report being rendered in sched_options.format
+typedef struct {
+    const ProcessTable *table;
+    const char *mode;
+    int cores;              // 0 for the single-core engine
+    long long slices;
+    int last_row;                   // Last process dispatched, -1 before the first one
+    long long context_switches;     // Dispatches of a different process than the last one
+    long long dispatches;
+    long long idle_periods;
+    bool summary_gap;       // Blank line after the summary, as the Round Robin report has
+    Executor *executor;     // Real processes behind the slices, with --execute
+    Completions *completions;   // Filled by report_completion() when rows do not outlive the run
+    EngineStats *stats;         // With --stats
+    SummaryItem *items;
+    int item_count;
+    int item_capacity;
+} Report;
+
+void output_json_string(const char *s) {
+    output_bytes("\"", 1);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            output_bytes("\\", 1);
+            output_bytes(s, 1);
+        } else if ((unsigned char)*s < 0x20) {
+            output_format("\\u%04x", (unsigned char)*s);
+        } else {
+            output_bytes(s, 1);
+        }
+    }
+    output_bytes("\"", 1);
+}
 
-            simulate_time(temp[highest_priority_idx].burst_time);
-            current_time += temp[highest_priority_idx].burst_time;
-            temp[highest_priority_idx].completion_time = current_time;
-            is_completed[highest_priority_idx] = 1;
-            completed++;
+void report_begin(Report *r, const ProcessTable *t, const char *mode, int cores) {
+    memset(r, 0, sizeof(*r));
+    r->table = t;
+    r->mode = mode;
+    r->cores = cores;
+    r->last_row = -1;
+    if (sched_options.stats) {
+        r->stats = calloc(1, sizeof(EngineStats));
+        if (!r->stats) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
+        }
+    }
+    if (sched_options.execute) {
+        r->executor = start_executor(t);
+        if (!r->executor) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
         }
     }
 
-    double avg_waiting_time = total_waiting_time / n;
-    printf("\n──────────────────────────────────────────────\n");
-    printf(">> Engine Status  : Completed\n");
-    printf(">> Summary        :\n");
-    printf("   └─ Average Waiting Time : %.2f time units\n", avg_waiting_time);
-    printf(">> End of Report\n");
-    printf("══════════════════════════════════════════════\n\n");
+    switch (sched_options.format) {
+        case FORMAT_HUMAN:
+        case FORMAT_SUMMARY:
+            output_string("══════════════════════════════════════════════\n");
+            if (cores > 0) {
+                output_format(">> Scheduler Mode : %s (%d cores)\n", mode, cores);
+            } else {
+                output_format(">> Scheduler Mode : %s\n", mode);
+            }
+            if (sched_options.format == FORMAT_HUMAN) {
+                output_string(">> Engine Status  : Initialized\n");
+                output_string("──────────────────────────────────────────────\n\n");
+            }
+            break;
+        case FORMAT_JSON:
+            output_string("{\"algorithm\":");
+            output_json_string(mode);
+            output_format(",\"cores\":%d,\"slices\":[", cores > 0 ? cores : 1);
+            break;
+        case FORMAT_CSV:
+        case FORMAT_NONE:
+            break;
+    }
 }
 
+// Record that `core` ran `row` (or was idle, row == -1) from start to end
+void report_slice(Report *r, int core, int start, int end, int row) {
+    const ProcessTable *t = r->table;
 
-void init_queue(Queue* q) {
-    q->front = q->rear = 0;
-}
+    switch (sched_options.format) {
+        case FORMAT_HUMAN:
+            if (r->cores > 0) {
+                output_string("[Core ");
+                output_int(core);
+                output_bytes("] ", 2);
+            }
+            output_int(start);
+            output_bytes(" → ", strlen(" → "));
+            output_int(end);
+            if (row == -1) {
+                output_string(": Idle.\n");
+            } else {
+                output_bytes(": ", 2);
+                output_string(process_name(t, row));
+                output_string(" Running ");
+                output_string(process_description(t, row));
+                output_bytes(".\n", 2);
+            }
+            break;
+        case FORMAT_CSV:
+            output_string(r->mode);
+            output_bytes(",", 1);
+            output_int(core);
+            output_bytes(",", 1);
+            output_int(start);
+            output_bytes(",", 1);
+            output_int(end);
+            output_bytes(",", 1);
+            if (row != -1) output_string(process_name(t, row));
+            output_bytes("\n", 1);
+            break;
+        case FORMAT_JSON:
+            output_string(r->slices > 0 ? ",[" : "[");
+            output_int(core);
+            output_bytes(",", 1);
+            output_int(start);
+            output_bytes(",", 1);
+            output_int(end);
+            output_bytes(",", 1);
+            if (row == -1) {
+                output_string("null");
+            } else {
+                output_json_string(process_name(t, row));
+            }
+            output_bytes("]", 1);
+            break;
+        case FORMAT_SUMMARY:
+        case FORMAT_NONE:
+            break;
+    }
+    r->slices++;
 
-bool is_empty(Queue* q) {
-    return q->front == q->rear;
-}
+    // Nothing may be buffered while a real process runs for the slice
+    if (r->executor) {
+        flush_output();
+        execute_slice(r->executor, t, start, end, row);
+    }
 
-void enqueue(Queue* q, Process* p) {
-    q->data[q->rear++] = p;
+    if (row != -1) {
+        if (r->last_row != -1 && row != r->last_row) r->context_switches++;
+        r->last_row = row;
+        r->dispatches++;
+    } else {
+        r->idle_periods++;
+    }
 }
 
-Process* dequeue(Queue* q) {
-    return q->data[q->front++];
-}
+// Add a summary line; values starting with a digit are numbers in the JSON output
+void report_summary(Report *r, const char *label, const char *unit, const char *fmt, ...) {
+    if (r->item_count == r->item_capacity) {
+        int capacity = r->item_capacity ? r->item_capacity * 2 : 8;
+        SummaryItem *grown = realloc(r->items, sizeof(SummaryItem) * capacity);
+        if (!grown) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
+        }
+        r->items = grown;
+        r->item_capacity = capacity;
+    }
 
+    SummaryItem *item = &r->items[r->item_count++];
+    snprintf(item->label, sizeof(item->label), "%s", label);
+    snprintf(item->unit, sizeof(item->unit), "%s", unit);
 
-int compare_processes(const void* a, const void* b) {
-    Process* p1 = (Process*)a;
-    Process* p2 = (Process*)b;
-    if (p1->arrival_time != p2->arrival_time)
-        return p1->arrival_time - p2->arrival_time;
-    return p1->original_order - p2->original_order;
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(item->value, sizeof(item->value), fmt, args);
+    va_end(args);
 }
-void schedule_round_robin(Process processes[], int n, int timeQuantum) {
-    printf("══════════════════════════════════════════════\n");
-    printf(">> Scheduler Mode : Round Robin\n");
-    printf(">> Engine Status  : Initialized\n");
-    printf("──────────────────────────────────────────────\n\n");
-
-    int current_time = 0;
-    int completed = 0;
-
-    // Total turnaround time is sum of all burst times
-    int total_turnaround_time = 0;
-    for (int i = 0; i < n; i++) {
-        total_turnaround_time += processes[i].burst_time;
-        processes[i].remaining_time = processes[i].burst_time; // Initialize remaining time
-        processes[i].start_time = -1; // Mark start time as not started
-    }
 
-    Queue queue;
-    init_queue(&queue);
+void report_histogram(Report *r, const char *name, const char *unit, const Histogram *h) {
+    char label[40];
+    snprintf(label, sizeof(label), "%s Mean", name);
+    report_summary(r, label, unit, "%.2f", h->total ? h->sum / h->total : 0);
+    snprintf(label, sizeof(label), "%s p50", name);
+    report_summary(r, label, unit, "%d", histogram_percentile(h, 50));
+    snprintf(label, sizeof(label), "%s p90", name);
+    report_summary(r, label, unit, "%d", histogram_percentile(h, 90));
+    snprintf(label, sizeof(label), "%s p99", name);
+    report_summary(r, label, unit, "%d", histogram_percentile(h, 99));
+    snprintf(label, sizeof(label), "%s Max", name);
+    report_summary(r, label, unit, "%d", h->max);
+}
 
-    bool added[MAX_PROCESSES] = { false };
+// A process finished; only engines that reuse its row need to report this
+void report_completion(Report *r, int row) {
+    if (r->completions) record_completion(r->completions, r->table, row);
+}
 
-    // Enqueue all processes that arrive at time 0
-    for (int i = 0; i < n; i++) {
-        if (processes[i].arrival_time <= current_time) {
-            enqueue(&queue, &processes[i]);
-            added[i] = true;
+// Per-process turnaround, response and waiting times of the finished run, plus
+// throughput and CPU utilization over the whole schedule
+void report_metrics(Report *r) {
+    const ProcessTable *t = r->table;
+    Completions *c = r->completions;
+    if (!c) {
+        c = calloc(1, sizeof(Completions));
+        if (!c) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
+        }
+        for (int i = 0; i < t->count; i++) {
+            record_completion(c, t, i);
         }
     }
 
-    while (completed < n) {
-        if (is_empty(&queue)) {
-            // CPU is idle, jump to next process arrival time
-            int next_arrival = INT_MAX;
-            for (int i = 0; i < n; i++) {
-                if (!added[i] && processes[i].arrival_time < next_arrival) {
-                    next_arrival = processes[i].arrival_time;
-                }
-            }
+    report_histogram(r, "Turnaround", " time units", &c->turnaround);
+    report_histogram(r, "Response", " time units", &c->response);
+    report_histogram(r, "Waiting", " time units", &c->waiting);
 
-            // Print idle time
-            printf("%d → %d: Idle.\n", current_time, next_arrival);
-            simulate_time(next_arrival - current_time);
-            total_turnaround_time += next_arrival - current_time;
-            current_time = next_arrival;
-
-            // Enqueue processes that arrive now
-            for (int i = 0; i < n; i++) {
-                if (!added[i] && processes[i].arrival_time <= current_time) {
-                    enqueue(&queue, &processes[i]);
-                    added[i] = true;
-                }
-            }
-        } else {
-            // Dequeue next process
-            Process* p = dequeue(&queue);
+    int cores = r->cores > 0 ? r->cores : 1;
+    report_summary(r, "Throughput", " processes/time unit", "%.4f",
+                   c->makespan > 0 ? (double)c->count / c->makespan : 0);
+    report_summary(r, "CPU Utilization", "%", "%.2f",
+                   c->makespan > 0 ? 100.0 * c->busy_time / ((double)c->makespan * cores) : 0);
 
-            if (p->start_time == -1) {
-                p->start_time = current_time;
-            }
+    if (c != r->completions) free(c);
+}
 
-            int exec_time = (p->remaining_time < timeQuantum) ? p->remaining_time : timeQuantum;
+// Stop the last child and summarize how the real processes kept up with the simulated schedule
+void report_execution(Report *r) {
+    Executor *e = r->executor;
+    const ProcessTable *t = r->table;
 
-            printf("%d → %d: %s Running %s.\n", current_time, current_time + exec_time, p->name, p->description);
-            simulate_time(exec_time);
+    if (e->running != -1) stop_running(e, t);
+    for (int i = 0; i < t->count; i++) {
+        if (e->pid[i] > 0) {
+            kill(e->pid[i], SIGKILL);
+            waitpid(e->pid[i], NULL, 0);
+        }
+    }
 
-            int end_time = current_time + exec_time;
-            p->remaining_time -= exec_time;
+    report_summary(r, "Real Processes", "", "%d", e->reaped);
+    report_summary(r, "Dispatch Latency Mean", " us", "%.1f",
+                   e->dispatches ? e->latency_total_ns / 1e3 / e->dispatches : 0);
+    report_summary(r, "Dispatch Latency Max", " us", "%.1f", e->latency_max_ns / 1e3);
+    report_summary(r, "Context Switch Mean", " us", "%.1f",
+                   e->switches ? e->switch_total_ns / 1e3 / e->switches : 0);
+    report_summary(r, "Context Switch Max", " us", "%.1f", e->switch_max_ns / 1e3);
+    report_summary(r, "Achieved CPU Share", "%", "%.2f",
+                   e->burst_seconds > 0 ? 100.0 * e->cpu_seconds / e->burst_seconds : 0);
+    report_summary(r, "Lowest CPU Share", "%", "%.2f", e->min_share > 0 ? 100.0 * e->min_share : 0);
+
+    munmap(e->slots, sizeof(ExecSlot) * t->count);
+    free(e->pid);
+    free(e->executed);
+    free(e);
+    r->executor = NULL;
+}
 
-            Process* to_enqueue[MAX_PROCESSES];
-            int enqueue_count = 0;
+// Add the engine's hot-path counters and phase timings to the summary, with --stats
+void report_stats(Report *r) {
+    EngineStats *s = r->stats;
+    report_summary(r, "Dispatches", "", "%lld", r->dispatches);
+    report_summary(r, "Context Switches", "", "%lld", r->context_switches);
+    report_summary(r, "Idle Periods", "", "%lld", r->idle_periods);
+    if (s->timed) {
+        report_histogram(r, "Ready Queue", " processes", &s->ready_length);
+        report_summary(r, "Selection Time", " ns", "%lld", s->ns[STATS_SELECT]);
+        report_summary(r, "Output Time", " ns", "%lld", s->ns[STATS_OUTPUT]);
+    }
+    report_summary(r, "Parse Time", " ns", "%lld", parse_ns);
+}
 
-            // Add newly arrived processes before or at end_time
-            for (int i = 0; i < n; i++) {
-                if (!added[i] && processes[i].arrival_time <= end_time) {
-                    to_enqueue[enqueue_count++] = &processes[i];
-                    added[i] = true;
-                }
+// Write the summary and hand the finished report to write()
+void report_end(Report *r) {
+    if (r->executor) report_execution(r);
+    if (sched_options.metrics) report_metrics(r);
+    if (r->stats) report_stats(r);
+
+    switch (sched_options.format) {
+        case FORMAT_HUMAN:
+        case FORMAT_SUMMARY:
+            if (sched_options.format == FORMAT_HUMAN) {
+                output_string("\n──────────────────────────────────────────────\n");
             }
-
-            // If process not finished, re-add it
-            if (p->remaining_time > 0) {
-                to_enqueue[enqueue_count++] = p;
-            } else {
-                p->completion_time = end_time;
-                p->waiting_time = p->completion_time - p->arrival_time - p->burst_time;
-                completed++;
+            output_string(">> Engine Status  : Completed\n");
+            output_string(">> Summary        :\n");
+            for (int k = 0; k < r->item_count; k++) {
+                SummaryItem *item = &r->items[k];
+                output_format("   %s─ %s : %s%s\n", k == r->item_count - 1 ? "└" : "├",
+                              item->label, item->value, item->unit);
             }
-
-            // Sort by original order to prioritize lower index first on tie
-            for (int i = 0; i < enqueue_count - 1; i++) {
-                for (int j = i + 1; j < enqueue_count; j++) {
-                    if (to_enqueue[i]->original_order > to_enqueue[j]->original_order) {
-                        Process* temp = to_enqueue[i];
-                        to_enqueue[i] = to_enqueue[j];
-                        to_enqueue[j] = temp;
-                    }
+            if (r->summary_gap) output_bytes("\n", 1);
+            output_string(">> End of Report\n");
+            output_string("══════════════════════════════════════════════\n\n");
+            break;
+        case FORMAT_JSON:
+            output_string("],\"summary\":{");
+            for (int k = 0; k < r->item_count; k++) {
+                SummaryItem *item = &r->items[k];
+                char key[sizeof(item->label)];
+                int len = 0;
+                for (const char *c = item->label; *c; c++) {
+                    key[len++] = *c == ' ' ? '_' : (*c >= 'A' && *c <= 'Z') ? *c - 'A' + 'a' : *c;
+                }
+                key[len] = '\0';
+
+                if (k > 0) output_bytes(",", 1);
+                output_json_string(key);
+                output_bytes(":", 1);
+                if (item->value[0] >= '0' && item->value[0] <= '9') {
+                    output_string(item->value);
+                } else {
+                    output_json_string(item->value);
                 }
             }
-
-            // Enqueue all
-            for (int i = 0; i < enqueue_count; i++) {
-                enqueue(&queue, to_enqueue[i]);
-            }
-
-            current_time = end_time;
-        }
+            output_string("}}\n");
+            break;
+        case FORMAT_CSV:
+        case FORMAT_NONE:
+            break;
     }
 
-    printf("\n──────────────────────────────────────────────\n");
-    printf(">> Engine Status  : Completed\n");
-    printf(">> Summary        :\n");
-    printf("   └─ Total Turnaround Time : %d time units\n\n", total_turnaround_time);
-    printf(">> End of Report\n");
-    printf("══════════════════════════════════════════════\n\n");
+    free(r->items);
+    free(r->completions);
+    free(r->stats);
+    r->items = NULL;
+    r->completions = NULL;
+    r->stats = NULL;
+    flush_output();
 }
 
+// Binary min-heap of table rows, ordered by one of the compare_* functions above.
+// Used as the ready queue of SJF and Priority.
+typedef struct {
+    int *data;
+    int size;
+    int capacity;
+    const ProcessTable *table;
+    int (*compare)(const ProcessTable *, int, int);
+} ReadyHeap;
+
+int init_heap(ReadyHeap *h, const ProcessTable *t, int (*compare)(const ProcessTable *, int, int),
+              int capacity) {
+    h->capacity = capacity > 0 ? capacity : 1;
+    h->data = malloc(sizeof(int) * h->capacity);
+    h->size = 0;
+    h->table = t;
+    h->compare = compare;
+    return h->data != NULL;
+}
 
+void free_heap(ReadyHeap *h) {
+    free(h->data);
+    h->data = NULL;
+}
 
+// Returns true if the process at heap slot i must be dispatched before the one at slot j
+bool heap_before(ReadyHeap *h, int i, int j) {
+    return h->compare(h->table, h->data[i], h->data[j]) < 0;
+}
 
-// Main CPU Scheduler function
-void runCPUScheduler(char* processesCsvFilePath, int timeQuantum) {
-    Process processes[MAX_PROCESSES];
-    int n = read_processes(processesCsvFilePath, processes);
+void heap_swap(ReadyHeap *h, int i, int j) {
+    int tmp = h->data[i];
+    h->data[i] = h->data[j];
+    h->data[j] = tmp;
+}
 
-    if (n <= 0) {
-        fprintf(stderr, "Error: Could not read processes from file\n");
-        return;
+void heap_push(ReadyHeap *h, int idx) {
+    if (h->size == h->capacity) {
+        int *grown = realloc(h->data, sizeof(int) * h->capacity * 2);
+        if (!grown) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
+        }
+        h->data = grown;
+        h->capacity *= 2;
     }
 
-    // Flush output to prevent buffering issues that cause duplication
-    fflush(stdout);
-    fflush(stderr);
+    int i = h->size++;
+    h->data[i] = idx;
 
-    // Run all four scheduling algorithms
-    schedule_fcfs(processes, n);
-    fflush(stdout);  // Ensure clean output between algorithms
+    // Sift up
+    while (i > 0 && heap_before(h, i, (i - 1) / 2)) {
+        heap_swap(h, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
 
-    schedule_sjf(processes, n);
+int heap_pop(ReadyHeap *h) {
+    int top = h->data[0];
+    h->data[0] = h->data[--h->size];
+
+    // Sift down
+    int i = 0;
+    while (1) {
+        int left = 2 * i + 1, right = left + 1, best = i;
+        if (left < h->size && heap_before(h, left, best)) best = left;
+        if (right < h->size && heap_before(h, right, best)) best = right;
+        if (best == i) break;
+        heap_swap(h, i, best);
+        i = best;
+    }
+    return top;
+}
+
+// SRTF orders ready processes by the time they still need
+int compare_srtf(const ProcessTable *t, int a, int b) {
+    if (t->remaining_time[a] != t->remaining_time[b])
+        return t->remaining_time[a] - t->remaining_time[b];
+    return compare_fcfs(t, a, b);
+}
+
+int init_queue(Queue* q, int capacity) {
+    q->capacity = capacity > 0 ? capacity : 1;
+    q->data = malloc(sizeof(int) * q->capacity);
+    q->head = q->size = 0;
+    return q->data != NULL;
+}
+
+void free_queue(Queue* q) {
+    free(q->data);
+    q->data = NULL;
+}
+
+bool is_empty(Queue* q) {
+    return q->size == 0;
+}
+
+// Double the ring, moving the wrapped-around front part after the old end
+int grow_queue(Queue* q) {
+    int *grown = realloc(q->data, sizeof(int) * q->capacity * 2);
+    if (!grown) return 0;
+
+    int wrapped = q->head + q->size - q->capacity;
+    if (wrapped > 0) {
+        memcpy(grown + q->capacity, grown, sizeof(int) * wrapped);
+    }
+    q->data = grown;
+    q->capacity *= 2;
+    return 1;
+}
+
+void enqueue(Queue* q, int idx) {
+    if (q->size == q->capacity && !grow_queue(q)) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+
+    int tail = q->head + q->size;
+    if (tail >= q->capacity) tail -= q->capacity;
+    q->data[tail] = idx;
+    q->size++;
+}
+
+int dequeue(Queue* q) {
+    int idx = q->data[q->head];
+    if (++q->head == q->capacity) q->head = 0;
+    q->size--;
+    return idx;
+}
+
+// Take the most recently queued row from the back of the ring
+int dequeue_back(Queue* q) {
+    q->size--;
+    int tail = q->head + q->size;
+    if (tail >= q->capacity) tail -= q->capacity;
+    return q->data[tail];
+}
+
+// qsort() helper for ordering a batch of rows by their position in the input
+int compare_original_order(const void *a, const void *b) {
+    return sort_table->original_order[*(const int *)a] - sort_table->original_order[*(const int *)b];
+}
+
+// Enqueue a batch in input order, the tie-break Round Robin uses for processes that
+// become ready at the same slice boundary. Batches coming off the arrival cursor are
+// usually sorted already, so the sort only runs when they are not.
+void enqueue_batch(const ProcessTable *t, Queue *q, int *batch, int count) {
+    for (int i = 1; i < count; i++) {
+        if (t->original_order[batch[i - 1]] > t->original_order[batch[i]]) {
+            sort_table = t;
+            qsort(batch, count, sizeof(int), compare_original_order);
+            break;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        enqueue(q, batch[i]);
+    }
+}
+
+// Reads process records from a pipe, FIFO or file one at a time, as the online engine needs them
+typedef struct {
+    int fd;
+    const char *name;
+    char *buf;
+    size_t capacity;
+    size_t start, used;     // Unread bytes are buf[start, used)
+    bool eof;
+    long line_no;
+    int last_arrival;       // Arrival of the previous record; no record is admitted earlier
+} StreamReader;
+
+// Parse the next record of the stream into a table row. Returns the row, or -1
+// at the end of the stream. Output is flushed before blocking for more input.
+// The engine needs arrivals in order, so a record that arrives before the one
+// ahead of it is admitted at that record's arrival time, with a warning.
+int read_next_process(StreamReader *s, ProcessTable *t) {
+    while (1) {
+        char *newline = memchr(s->buf + s->start, '\n', s->used - s->start);
+        if (newline || (s->eof && s->start < s->used)) {
+            const char *line = s->buf + s->start;
+            size_t len = newline ? (size_t)(newline - line) : s->used - s->start;
+            s->start += newline ? len + 1 : len;
+            s->line_no++;
+
+            long long parse_start = sched_options.stats ? monotonic_ns() : 0;
+            int row = parse_csv_record(line, len, s->line_no, s->name, t);
+            if (sched_options.stats) parse_ns += monotonic_ns() - parse_start;
+            if (row == -1) {
+                fprintf(stderr, "Error: Out of memory\n");
+                exit(1);
+            }
+            if (row == ROW_SKIPPED) continue;
+
+            if (t->arrival_time[row] < s->last_arrival) {
+                fprintf(stderr, "Warning: %s:%ld: arrival %d is before the previous record's %d; admitted at %d\n",
+                        s->name, s->line_no, t->arrival_time[row], s->last_arrival, s->last_arrival);
+                t->arrival_time[row] = s->last_arrival;
+            }
+            s->last_arrival = t->arrival_time[row];
+            return row;
+        }
+        if (s->eof) return -1;
+
+        // Keep the partial line at the front, grow only if one line fills the buffer
+        memmove(s->buf, s->buf + s->start, s->used - s->start);
+        s->used -= s->start;
+        s->start = 0;
+        if (s->used == s->capacity) {
+            char *grown = realloc(s->buf, s->capacity * 2);
+            if (!grown) {
+                fprintf(stderr, "Error: Out of memory\n");
+                exit(1);
+            }
+            s->buf = grown;
+            s->capacity *= 2;
+        }
+
+        flush_output();
+        ssize_t bytes_read = read(s->fd, s->buf + s->used, s->capacity - s->used);
+        if (bytes_read < 0 && errno == EINTR) continue;
+        if (bytes_read < 0) perror("Error reading stream");
+        if (bytes_read <= 0) {
+            s->eof = true;
+        } else {
+            s->used += bytes_read;
+        }
+    }
+}
+
+// Where the engine's processes come from: the arrival-sorted table, or a stream
+// that is read one record ahead (see schedule_online)
+typedef struct {
+    ProcessTable *table;
+    int cursor;             // Next index into table->by_arrival
+    StreamReader *stream;   // NULL when scheduling the whole table
+    int next;               // Stream record read but not yet arrived, -1 at the end
+} ArrivalSource;
+
+// The next process to arrive, or -1 when there are no more
+int peek_arrival(const ArrivalSource *s) {
+    if (s->stream) return s->next;
+    return s->cursor < s->table->count ? s->table->by_arrival[s->cursor] : -1;
+}
+
+void take_arrival(ArrivalSource *s) {
+    if (s->stream) {
+        s->next = read_next_process(s->stream, s->table);
+    } else {
+        s->cursor++;
+    }
+}
+
+// Move every process that has arrived by `time` into batch[count...], growing it
+// as needed. One slot is always left free for the process whose slice just ended.
+int collect_ready(ArrivalSource *s, int time, int **batch, int *capacity, int count) {
+    for (int p = peek_arrival(s); p != -1 && s->table->arrival_time[p] <= time; p = peek_arrival(s)) {
+        if (count + 1 == *capacity) {
+            int *grown = realloc(*batch, sizeof(int) * *capacity * 2);
+            if (!grown) {
+                fprintf(stderr, "Error: Out of memory\n");
+                exit(1);
+            }
+            *batch = grown;
+            *capacity *= 2;
+        }
+        (*batch)[count++] = p;
+        take_arrival(s);
+    }
+    return count;
+}
+
+// Running totals the engine hands to a policy's summary
+typedef struct {
+    int completed;
+    double total_waiting_time;
+    long long busy_time;
+    long long idle_time;
+} EngineTotals;
+
+typedef struct Policy Policy;
+
+// A scheduling policy plugged into run_policy. The engine owns the clock, the
+// arrivals, idle periods, reporting and completion bookkeeping; a policy only
+// keeps its ready set and decides what runs next and for how long.
+struct Policy {
+    const char *mode;
+    ProcessTable *table;
+    int quantum;            // Longest slice, INT_MAX for run-to-completion policies
+    ReadyHeap ready;        // Ready set of the heap-ordered policies
+    Queue queue;            // Ready set of the FIFO policies
+    void *state;            // Anything else a policy keeps, e.g. the MLFQ levels
+
+    // Processes that became ready at `time`, in arrival order. Called at every
+    // slice boundary, with count 0 when nothing arrived.
+    void (*on_arrival)(Policy *p, int time, int *batch, int count);
+    // The next process to run and the longest slice it may get, or -1 when none is ready
+    int (*pick_next)(Policy *p, int time, int *slice);
+    // Optional: cut the running slice short when `arrived` should run instead
+    bool (*preempts)(Policy *p, int arrived, int running);
+    // A slice of `row` that ran `ran` time units ended. An unfinished row is requeued
+    // by the policy, or appended to the batch of processes ready at this boundary.
+    void (*on_slice_end)(Policy *p, int row, int ran, bool finished, int *batch, int *count);
+    void (*summarize)(Policy *p, Report *r, const EngineTotals *totals);
+};
+
+// The event-driven engine under every single-core policy. Time jumps from one
+// slice boundary to the next: the processes that arrived by then are handed to
+// the policy, which picks what runs next and for how long. For a policy with a
+// preempts hook, each arrival during the slice is admitted at its arrival time
+// and the slice ends at the first one that preempts it, so every slice's end is
+// known before the slice is printed. Returns the number of context switches.
+long long run_policy(Policy *pol, ArrivalSource *src) {
+    ProcessTable *t = pol->table;
+    int batch_capacity = INITIAL_TABLE_CAPACITY;
+    int *batch = malloc(sizeof(int) * batch_capacity);
+    if (!batch) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+
+    Report report;
+    report_begin(&report, t, pol->mode, 0);
+
+    // Rows of a stream are reused, so metrics are recorded as processes complete
+    if (src->stream && sched_options.metrics) {
+        report.completions = calloc(1, sizeof(Completions));
+        if (!report.completions) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
+        }
+    }
+    if (!src->stream) {
+        for (int i = 0; i < t->count; i++) {
+            t->remaining_time[i] = t->burst_time[i];
+            t->start_time[i] = -1;
+        }
+    }
+
+    EngineStats *stats = report.stats;
+    if (stats) stats->timed = true;
+
+    EngineTotals totals = { 0 };
+    int current_time = 0;
+    int count = collect_ready(src, current_time, &batch, &batch_capacity, 0);
+    int admitted = count;
+    stats_start(stats);
+    pol->on_arrival(pol, current_time, batch, count);
+    stats_lap(stats, STATS_SELECT);
+
+    while (1) {
+        int slice;
+        int p = pol->pick_next(pol, current_time, &slice);
+        stats_lap(stats, STATS_SELECT);
+
+        if (p == -1) {
+            int next = peek_arrival(src);
+            if (next == -1) break;
+
+            // CPU is idle, jump to next process arrival time
+            int arrival = t->arrival_time[next];
+            report_slice(&report, 0, current_time, arrival, -1);
+            stats_lap(stats, STATS_OUTPUT);
+            simulate_time(arrival - current_time);
+            totals.idle_time += arrival - current_time;
+            current_time = arrival;
+
+            count = collect_ready(src, current_time, &batch, &batch_capacity, 0);
+            admitted += count;
+            stats_start(stats);
+            pol->on_arrival(pol, current_time, batch, count);
+            stats_lap(stats, STATS_SELECT);
+            continue;
+        }
+
+        if (stats) {
+            histogram_add(&stats->ready_length, admitted - totals.completed - 1);
+        }
+
+        if (t->start_time[p] == -1) {
+            t->start_time[p] = current_time;
+        }
+
+        int remaining = t->remaining_time[p];
+        int end_time = current_time + slice;
+
+        // Walk the arrivals that happen before the slice ends, stopping at the first one that preempts it
+        if (pol->preempts) {
+            for (int q = peek_arrival(src); q != -1 && t->arrival_time[q] < end_time; q = peek_arrival(src)) {
+                take_arrival(src);
+                admitted++;
+                t->remaining_time[p] = remaining - (t->arrival_time[q] - current_time);
+                stats_start(stats);
+                pol->on_arrival(pol, t->arrival_time[q], &q, 1);
+                bool preempted = pol->preempts(pol, q, p);
+                stats_lap(stats, STATS_SELECT);
+
+                if (preempted) {
+                    end_time = t->arrival_time[q];
+                    break;
+                }
+            }
+        }
+
+        int ran = end_time - current_time;
+        stats_start(stats);
+        report_slice(&report, 0, current_time, end_time, p);
+        stats_lap(stats, STATS_OUTPUT);
+        simulate_time(ran);
+
+        t->remaining_time[p] = remaining - ran;
+        totals.busy_time += ran;
+        current_time = end_time;
+
+        // Processes that arrived during the slice are ready together with an unfinished p
+        count = collect_ready(src, current_time, &batch, &batch_capacity, 0);
+        admitted += count;
+
+        bool finished = t->remaining_time[p] == 0;
+        if (finished) {
+            t->completion_time[p] = end_time;
+            t->waiting_time[p] = end_time - t->arrival_time[p] - t->burst_time[p];
+            totals.total_waiting_time += t->waiting_time[p];
+            totals.completed++;
+            report_completion(&report, p);
+        }
+        stats_start(stats);
+        pol->on_slice_end(pol, p, ran, finished, batch, &count);
+        if (finished && src->stream) {
+            release_row(t, p);
+        }
+        pol->on_arrival(pol, current_time, batch, count);
+        stats_lap(stats, STATS_SELECT);
+    }
+
+    free(batch);
+
+    pol->summarize(pol, &report, &totals);
+    report_end(&report);
+    return report.context_switches;
+}
+
+// Schedule the whole arrival-sorted table with a policy
+long long run_policy_on_table(Policy *pol) {
+    ArrivalSource src = { .table = pol->table, .cursor = 0, .stream = NULL, .next = -1 };
+    return run_policy(pol, &src);
+}
+
+void summarize_waiting(Policy *p, Report *r, const EngineTotals *totals) {
+    double avg_waiting_time = totals->completed > 0 ? totals->total_waiting_time / totals->completed : 0;
+    report_summary(r, "Average Waiting Time", " time units", "%.2f", avg_waiting_time);
+}
+
+// Round Robin reports busy plus idle time, i.e. when the last process finished
+void summarize_turnaround(Policy *p, Report *r, const EngineTotals *totals) {
+    report_summary(r, "Total Turnaround Time", " time units", "%lld", totals->busy_time + totals->idle_time);
+    r->summary_gap = true;
+}
+
+// A run-to-completion, non-preemptive policy with the average waiting time summary
+void init_policy(Policy *p, ProcessTable *t, const char *mode) {
+    memset(p, 0, sizeof(*p));
+    p->mode = mode;
+    p->table = t;
+    p->quantum = INT_MAX;
+    p->summarize = summarize_waiting;
+}
+
+void free_policy(Policy *p) {
+    free_heap(&p->ready);
+    free_queue(&p->queue);
+    free(p->state);
+}
+
+int slice_for(const Policy *p, int row) {
+    int remaining = p->table->remaining_time[row];
+    return remaining < p->quantum ? remaining : p->quantum;
+}
+
+// FCFS and Round Robin: a ring-buffer ready queue, so every dispatch costs O(1)
+void fcfs_on_arrival(Policy *p, int time, int *batch, int count) {
+    for (int k = 0; k < count; k++) {
+        enqueue(&p->queue, batch[k]);
+    }
+}
+
+// Round Robin queues processes that become ready at the same slice boundary,
+// the preempted one included, in input order
+void round_robin_on_arrival(Policy *p, int time, int *batch, int count) {
+    enqueue_batch(p->table, &p->queue, batch, count);
+}
+
+int queue_pick_next(Policy *p, int time, int *slice) {
+    if (is_empty(&p->queue)) return -1;
+    int row = dequeue(&p->queue);
+    *slice = slice_for(p, row);
+    return row;
+}
+
+void queue_on_slice_end(Policy *p, int row, int ran, bool finished, int *batch, int *count) {
+    if (!finished) batch[(*count)++] = row;
+}
+
+// SJF, Priority and their preemptive forms: a heap ordered by a compare_* function
+void heap_on_arrival(Policy *p, int time, int *batch, int count) {
+    for (int k = 0; k < count; k++) {
+        heap_push(&p->ready, batch[k]);
+    }
+}
+
+int heap_pick_next(Policy *p, int time, int *slice) {
+    if (p->ready.size == 0) return -1;
+    int row = heap_pop(&p->ready);
+    *slice = slice_for(p, row);
+    return row;
+}
+
+void heap_on_slice_end(Policy *p, int row, int ran, bool finished, int *batch, int *count) {
+    if (!finished) heap_push(&p->ready, row);
+}
+
+// A newly arrived process preempts the running one if it compares lower. Since
+// the running process only gets better as it runs, an arrival that does not
+// preempt it immediately never will.
+bool heap_preempts(Policy *p, int arrived, int running) {
+    return p->ready.compare(p->table, arrived, running) < 0;
+}
+
+// Set up one of the classic policies: fcfs, sjf, priority, rr, srtf or preemptive-priority
+void init_classic_policy(Policy *p, ProcessTable *t, Algorithm alg, int timeQuantum) {
+    static const char *modes[] = { "FCFS", "SJF", "Priority", "Round Robin", "SRTF", "Preemptive Priority" };
+    init_policy(p, t, modes[alg]);
+
+    bool ok;
+    if (alg == ALG_FCFS || alg == ALG_ROUND_ROBIN) {
+        ok = init_queue(&p->queue, INITIAL_TABLE_CAPACITY);
+        p->on_arrival = alg == ALG_FCFS ? fcfs_on_arrival : round_robin_on_arrival;
+        p->pick_next = queue_pick_next;
+        p->on_slice_end = queue_on_slice_end;
+    } else {
+        int (*compare)(const ProcessTable *, int, int) =
+            alg == ALG_SJF ? compare_sjf : alg == ALG_SRTF ? compare_srtf : compare_priority;
+        ok = init_heap(&p->ready, t, compare, INITIAL_TABLE_CAPACITY);
+        p->on_arrival = heap_on_arrival;
+        p->pick_next = heap_pick_next;
+        p->on_slice_end = heap_on_slice_end;
+        if (alg == ALG_SRTF || alg == ALG_PREEMPTIVE_PRIORITY) p->preempts = heap_preempts;
+    }
+
+    if (alg == ALG_ROUND_ROBIN) {
+        p->quantum = timeQuantum;
+        p->summarize = summarize_turnaround;
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+}
+
+long long schedule_classic(ProcessTable *t, Algorithm alg, int timeQuantum) {
+    Policy policy;
+    init_classic_policy(&policy, t, alg, timeQuantum);
+    long long context_switches = run_policy_on_table(&policy);
+    free_policy(&policy);
+    return context_switches;
+}
+
+// FCFS Scheduling
+void schedule_fcfs(ProcessTable *t) {
+    schedule_classic(t, ALG_FCFS, INT_MAX);
+}
+
+// SJF Scheduling (Non-preemptive)
+void schedule_sjf(ProcessTable *t) {
+    schedule_classic(t, ALG_SJF, INT_MAX);
+}
+
+// Priority Scheduling (Non-preemptive)
+void schedule_priority(ProcessTable *t) {
+    schedule_classic(t, ALG_PRIORITY, INT_MAX);
+}
+
+// Round Robin. Returns the number of context switches, which the quantum sweep compares.
+long long schedule_round_robin(ProcessTable *t, int timeQuantum) {
+    return schedule_classic(t, ALG_ROUND_ROBIN, timeQuantum);
+}
+
+// Shortest Remaining Time First (preemptive SJF)
+void schedule_srtf(ProcessTable *t) {
+    schedule_classic(t, ALG_SRTF, INT_MAX);
+}
+
+// Priority Scheduling (Preemptive)
+void schedule_preemptive_priority(ProcessTable *t) {
+    schedule_classic(t, ALG_PREEMPTIVE_PRIORITY, INT_MAX);
+}
+
+// Multi-Level Feedback Queue. New processes enter level 0; a process that uses
+// its whole quantum is demoted one level, and every boost period all waiting
+// processes are moved back to level 0 so long jobs cannot starve. Like Round
+// Robin, a slice is not cut short by arrivals, and processes that become ready
+// at the same slice boundary on the same level are queued in input order.
+typedef struct {
+    int levels;
+    int quantum[MLFQ_MAX_LEVELS];
+    Queue queue[MLFQ_MAX_LEVELS];
+    int *level;             // Current level of every row
+    int boost_period;
+    long long next_boost;
+    int boosts;
+} MlfqState;
+
+void mlfq_on_arrival(Policy *p, int time, int *batch, int count) {
+    MlfqState *m = p->state;
+    enqueue_batch(p->table, &m->queue[0], batch, count);
+
+    // Priority boost: everything waiting below level 0 moves back up, in level order
+    if (m->boost_period > 0 && time >= m->next_boost) {
+        for (int b = 1; b < m->levels; b++) {
+            while (!is_empty(&m->queue[b])) {
+                int row = dequeue(&m->queue[b]);
+                m->level[row] = 0;
+                enqueue(&m->queue[0], row);
+            }
+        }
+        m->boosts++;
+        while (m->next_boost <= time) m->next_boost += m->boost_period;
+    }
+}
+
+int mlfq_pick_next(Policy *p, int time, int *slice) {
+    MlfqState *m = p->state;
+    int l = 0;
+    while (l < m->levels && is_empty(&m->queue[l])) l++;
+    if (l == m->levels) return -1;
+
+    int row = dequeue(&m->queue[l]);
+    int remaining = p->table->remaining_time[row];
+    *slice = remaining < m->quantum[l] ? remaining : m->quantum[l];
+    return row;
+}
+
+void mlfq_on_slice_end(Policy *p, int row, int ran, bool finished, int *batch, int *count) {
+    MlfqState *m = p->state;
+    if (finished) return;
+
+    // Used the whole quantum: demote, unless already on the lowest level
+    if (m->level[row] < m->levels - 1) m->level[row]++;
+
+    if (m->level[row] == 0) {
+        batch[(*count)++] = row;
+    } else {
+        enqueue(&m->queue[m->level[row]], row);
+    }
+}
+
+void mlfq_summarize(Policy *p, Report *r, const EngineTotals *totals) {
+    MlfqState *m = p->state;
+    report_summary(r, "Priority Boosts", "", "%d", m->boosts);
+    summarize_waiting(p, r, totals);
+}
+
+void schedule_mlfq(ProcessTable *t, int timeQuantum) {
+    Policy policy;
+    init_policy(&policy, t, "MLFQ");
+    policy.on_arrival = mlfq_on_arrival;
+    policy.pick_next = mlfq_pick_next;
+    policy.on_slice_end = mlfq_on_slice_end;
+    policy.summarize = mlfq_summarize;
+
+    MlfqState *m = calloc(1, sizeof(MlfqState));
+    if (!m) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    policy.state = m;
+    m->levels = sched_options.mlfq_levels;
+    m->boost_period = sched_options.mlfq_boost;
+    m->next_boost = m->boost_period;
+
+    // Unset quanta default to the Round Robin quantum (at least 1), doubled on every
+    // level and capped at INT_MAX; the shift is done in long long so it cannot overflow
+    long long base = timeQuantum < 1 ? 1 : timeQuantum;
+    for (int l = 0; l < m->levels; l++) {
+        long long quantum = sched_options.mlfq_quanta[l] > 0 ? sched_options.mlfq_quanta[l] : base << l;
+        m->quantum[l] = quantum > INT_MAX ? INT_MAX : (int)quantum;
+    }
+
+    m->level = calloc(t->count, sizeof(int));
+    bool queues_ok = true;
+    for (int l = 0; l < m->levels; l++) {
+        queues_ok = init_queue(&m->queue[l], INITIAL_TABLE_CAPACITY) && queues_ok;
+    }
+    if (!m->level || !queues_ok) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+
+    run_policy_on_table(&policy);
+
+    for (int l = 0; l < m->levels; l++) {
+        free_queue(&m->queue[l]);
+    }
+    free(m->level);
+    free_policy(&policy);
+}
+
+// Proportional share: a process holds TICKET_SCALE / priority tickets, so priority 1
+// gets twice the CPU share of priority 2. Priorities below 1 count as 1.
+#define TICKET_SCALE 1000
+#define STRIDE_SCALE (1LL << 20)
+
+int process_tickets(const ProcessTable *t, int i) {
+    int priority = t->priority[i] < 1 ? 1 : t->priority[i];
+    int tickets = TICKET_SCALE / priority;
+    return tickets > 0 ? tickets : 1;
+}
+
+// xorshift64*, the generator of Trace-Generator.c
+uint64_t lottery_state;
+
+uint64_t lottery_random(void) {
+    lottery_state ^= lottery_state >> 12;
+    lottery_state ^= lottery_state << 25;
+    lottery_state ^= lottery_state >> 27;
+    return lottery_state * 0x2545F4914F6CDD1DULL;
+}
+
+// Fenwick tree over table rows holding the tickets of every runnable process
+typedef struct {
+    long long *tree;    // 1-based
+    int size;
+    int top;            // Highest power of two <= size
+    long long total;
+} TicketTree;
+
+int init_ticket_tree(TicketTree *f, int size) {
+    f->tree = calloc(size + 1, sizeof(long long));
+    f->size = size;
+    f->top = 1;
+    while (f->top * 2 <= size) f->top *= 2;
+    f->total = 0;
+    return f->tree != NULL;
+}
+
+void ticket_tree_add(TicketTree *f, int row, long long tickets) {
+    f->total += tickets;
+    for (int i = row + 1; i <= f->size; i += i & -i) {
+        f->tree[i] += tickets;
+    }
+}
+
+// Row holding the winning ticket, 0 <= ticket < total
+int ticket_tree_find(const TicketTree *f, long long ticket) {
+    int pos = 0;
+    for (int step = f->top; step > 0; step >>= 1) {
+        if (pos + step <= f->size && f->tree[pos + step] <= ticket) {
+            pos += step;
+            ticket -= f->tree[pos];
+        }
+    }
+    return pos;
+}
+
+// Pass values of the stride scheduler, read by compare_stride
+const long long *stride_pass;
+
+int compare_stride(const ProcessTable *t, int a, int b) {
+    if (stride_pass[a] != stride_pass[b])
+        return stride_pass[a] < stride_pass[b] ? -1 : 1;
+    return t->original_order[a] - t->original_order[b];
+}
+
+// Lottery and stride scheduling. Both run quantum-long slices, like Round Robin,
+// and give every runnable process CPU time in proportion to its tickets. Lottery
+// draws the next process at random from a Fenwick tree of tickets; stride runs
+// the process with the lowest pass, which advances by 1/tickets per time unit
+// used, so the shares hold exactly instead of on average. Both pick in O(log n).
+typedef struct {
+    TicketTree tickets;
+    long long *pass;
+    long long global_pass;  // Pass of the last dispatch; newcomers start there
+} ShareState;
+
+void lottery_on_arrival(Policy *p, int time, int *batch, int count) {
+    ShareState *s = p->state;
+    for (int k = 0; k < count; k++) {
+        ticket_tree_add(&s->tickets, batch[k], process_tickets(p->table, batch[k]));
+    }
+}
+
+int lottery_pick_next(Policy *p, int time, int *slice) {
+    ShareState *s = p->state;
+    if (s->tickets.total == 0) return -1;
+    int row = ticket_tree_find(&s->tickets, (long long)(lottery_random() % (uint64_t)s->tickets.total));
+    *slice = slice_for(p, row);
+    return row;
+}
+
+void lottery_on_slice_end(Policy *p, int row, int ran, bool finished, int *batch, int *count) {
+    ShareState *s = p->state;
+    if (finished) ticket_tree_add(&s->tickets, row, -process_tickets(p->table, row));
+}
+
+void lottery_summarize(Policy *p, Report *r, const EngineTotals *totals) {
+    report_summary(r, "Seed", "", "%llu", (unsigned long long)sched_options.seed);
+    summarize_waiting(p, r, totals);
+}
+
+void stride_on_arrival(Policy *p, int time, int *batch, int count) {
+    ShareState *s = p->state;
+    for (int k = 0; k < count; k++) {
+        s->pass[batch[k]] = s->global_pass;
+        heap_push(&p->ready, batch[k]);
+    }
+}
+
+int stride_pick_next(Policy *p, int time, int *slice) {
+    ShareState *s = p->state;
+    if (p->ready.size == 0) return -1;
+    int row = heap_pop(&p->ready);
+    s->global_pass = s->pass[row];
+    *slice = slice_for(p, row);
+    return row;
+}
+
+void stride_on_slice_end(Policy *p, int row, int ran, bool finished, int *batch, int *count) {
+    ShareState *s = p->state;
+    if (finished) return;
+    s->pass[row] += STRIDE_SCALE / process_tickets(p->table, row) * ran;
+    heap_push(&p->ready, row);
+}
+
+void schedule_proportional(ProcessTable *t, int timeQuantum, bool lottery) {
+    int n = t->count;
+
+    Policy policy;
+    init_policy(&policy, t, lottery ? "Lottery" : "Stride");
+    policy.quantum = timeQuantum < 1 ? 1 : timeQuantum;     // Like MLFQ, a 0-length slice would never end
+
+    ShareState *s = calloc(1, sizeof(ShareState));
+    bool ok = s != NULL;
+    if (ok) {
+        policy.state = s;
+        s->pass = malloc(sizeof(long long) * (n + 1));
+        ok = s->pass && (lottery ? init_ticket_tree(&s->tickets, n)
+                                 : init_heap(&policy.ready, t, compare_stride, INITIAL_TABLE_CAPACITY));
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+
+    if (lottery) {
+        policy.on_arrival = lottery_on_arrival;
+        policy.pick_next = lottery_pick_next;
+        policy.on_slice_end = lottery_on_slice_end;
+        policy.summarize = lottery_summarize;
+        lottery_state = (sched_options.seed + 1) * 0x9E3779B97F4A7C15ULL;
+        if (lottery_state == 0) lottery_state = 1;
+    } else {
+        policy.on_arrival = stride_on_arrival;
+        policy.pick_next = stride_pick_next;
+        policy.on_slice_end = stride_on_slice_end;
+        stride_pass = s->pass;
+    }
+
+    run_policy_on_table(&policy);
+
+    free(s->tickets.tree);
+    free(s->pass);
+    free_policy(&policy);
+}
+
+void schedule_lottery(ProcessTable *t, int timeQuantum) {
+    schedule_proportional(t, timeQuantum, true);
+}
+
+void schedule_stride(ProcessTable *t, int timeQuantum) {
+    schedule_proportional(t, timeQuantum, false);
+}
+
+// One simulated CPU of the multi-core engine
+typedef struct {
+    ReadyHeap heap;         // Run queue of FCFS, SJF and Priority
+    Queue queue;            // Run queue of Round Robin
+    Queue pending;          // Round Robin arrivals held until the running slice ends
+    long long queued_work;  // Remaining time of everything in the run queue
+    int running;            // Row on the CPU, -1 when idle
+    int slice_start, slice_end;
+    int idle_since;
+    long long busy_time;
+    int steals;             // Processes this core took from other run queues
+} Core;
+
+// A process becoming ready on a core at the current instant
+typedef struct {
+    int core;
+    int row;
+    int order;
+} ReadyEntry;
+
+int compare_ready_entries(const void *a, const void *b) {
+    const ReadyEntry *ea = a, *eb = b;
+    if (ea->core != eb->core) return ea->core - eb->core;
+    return ea->order - eb->order;
+}
+
+bool core_queue_empty(Core *c, bool round_robin) {
+    return round_robin ? is_empty(&c->queue) && is_empty(&c->pending) : c->heap.size == 0;
+}
+
+void core_push(const ProcessTable *t, Core *c, int p, bool round_robin) {
+    if (round_robin) {
+        enqueue(&c->queue, p);
+    } else {
+        heap_push(&c->heap, p);
+    }
+    c->queued_work += t->remaining_time[p];
+}
+
+// Take the next process to run; a thief takes from the back of a Round Robin queue,
+// the process its owner would have reached last
+int core_pop(const ProcessTable *t, Core *c, bool round_robin, bool steal) {
+    int p;
+    if (!round_robin) {
+        p = heap_pop(&c->heap);
+    } else if (steal) {
+        p = !is_empty(&c->pending) ? dequeue_back(&c->pending) : dequeue_back(&c->queue);
+    } else {
+        p = dequeue(&c->queue);
+    }
+    c->queued_work -= t->remaining_time[p];
+    return p;
+}
+
+// Work still owed by a core at `time`: its run queue plus what is left of the running process
+long long core_load(const ProcessTable *t, Core *c, int time) {
+    long long load = c->queued_work;
+    if (c->running != -1) {
+        load += t->remaining_time[c->running] - (time - c->slice_start);
+    }
+    return load;
+}
+
+// Pick the core a newly arrived process is queued on
+int place_process(const ProcessTable *t, Core *cores, int ncores, int p, int time) {
+    if (sched_options.placement == PLACE_AFFINITY) {
+        return t->original_order[p] % ncores;
+    }
+
+    int best = 0;
+    long long best_load = core_load(t, &cores[0], time);
+    for (int c = 1; c < ncores; c++) {
+        long long load = core_load(t, &cores[c], time);
+        if (load < best_load) {
+            best = c;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+// Multi-core simulation: every core runs the chosen algorithm on its own run queue.
+// Arrivals are placed least-loaded or by affinity, and a core whose run queue is
+// empty steals one process from the core with the most queued work. Time jumps
+// between arrivals and slice ends; a core's idle gap is printed when it picks up
+// work again.
+void schedule_multicore(ProcessTable *t, Algorithm alg, int timeQuantum) {
+    int n = t->count;
+    int ncores = sched_options.cores;
+    bool round_robin = (alg == ALG_ROUND_ROBIN);
+    int (*compare)(const ProcessTable *, int, int) =
+        alg == ALG_SJF ? compare_sjf : alg == ALG_PRIORITY ? compare_priority : compare_fcfs;
+    const char *mode = alg == ALG_FCFS ? "FCFS" : alg == ALG_SJF ? "SJF" :
+                       alg == ALG_PRIORITY ? "Priority" : "Round Robin";
+
+    Core *cores = calloc(ncores, sizeof(Core));
+    ReadyEntry *ready = malloc(sizeof(ReadyEntry) * (n + ncores));
+    if (!cores || !ready) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    for (int c = 0; c < ncores; c++) {
+        bool ok = round_robin ? init_queue(&cores[c].queue, INITIAL_TABLE_CAPACITY) &&
+                                init_queue(&cores[c].pending, INITIAL_TABLE_CAPACITY)
+                              : init_heap(&cores[c].heap, t, compare, INITIAL_TABLE_CAPACITY);
+        if (!ok) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
+        }
+        cores[c].running = -1;
+    }
+
+    Report report;
+    report_begin(&report, t, mode, ncores);
+
+    for (int i = 0; i < n; i++) {
+        t->remaining_time[i] = t->burst_time[i];
+        t->start_time[i] = -1;
+    }
+
+    int current_time = 0;
+    int completed = 0;
+    int next_arrival = 0;   // Cursor into t->by_arrival
+    int migrations = 0;
+    double total_waiting_time = 0;
+
+    while (completed < n) {
+        int ready_count = 0;
+
+        // Retire the slices that end now; unfinished Round Robin processes requeue on their core
+        for (int c = 0; c < ncores; c++) {
+            Core *core = &cores[c];
+            if (core->running == -1 || core->slice_end != current_time) continue;
+
+            int p = core->running;
+            core->busy_time += core->slice_end - core->slice_start;
+            t->remaining_time[p] -= core->slice_end - core->slice_start;
+            core->running = -1;
+            core->idle_since = current_time;
+
+            // Arrivals held during the slice queue together with the preempted process
+            while (round_robin && !is_empty(&core->pending)) {
+                int q = dequeue(&core->pending);
+                ready[ready_count++] = (ReadyEntry){ c, q, t->original_order[q] };
+            }
+
+            if (t->remaining_time[p] > 0) {
+                ready[ready_count++] = (ReadyEntry){ c, p, t->original_order[p] };
+                core->queued_work += t->remaining_time[p];
+            } else {
+                t->completion_time[p] = current_time;
+                t->waiting_time[p] = current_time - t->arrival_time[p] - t->burst_time[p];
+                total_waiting_time += t->waiting_time[p];
+                completed++;
+            }
+        }
+
+        // Place the processes that arrive now
+        while (next_arrival < n && t->arrival_time[t->by_arrival[next_arrival]] <= current_time) {
+            int p = t->by_arrival[next_arrival++];
+            int c = place_process(t, cores, ncores, p, current_time);
+            cores[c].queued_work += t->remaining_time[p];
+
+            // Round Robin only queues arrivals at slice boundaries, like the single-core engine
+            if (round_robin && cores[c].running != -1) {
+                enqueue(&cores[c].pending, p);
+            } else {
+                ready[ready_count++] = (ReadyEntry){ c, p, t->original_order[p] };
+            }
+        }
+
+        // Processes that become ready on the same core at the same time queue in input order
+        qsort(ready, ready_count, sizeof(ReadyEntry), compare_ready_entries);
+        for (int k = 0; k < ready_count; k++) {
+            cores[ready[k].core].queued_work -= t->remaining_time[ready[k].row];
+            core_push(t, &cores[ready[k].core], ready[k].row, round_robin);
+        }
+
+        // Idle cores run their own queue first, then steal from the most loaded core
+        for (int pass = 0; pass < 2; pass++) {
+            for (int c = 0; c < ncores; c++) {
+                Core *core = &cores[c];
+                if (core->running != -1) continue;
+
+                int p;
+                if (!core_queue_empty(core, round_robin)) {
+                    p = core_pop(t, core, round_robin, false);
+                } else if (pass == 1) {
+                    int victim = -1;
+                    for (int v = 0; v < ncores; v++) {
+                        if (v == c || core_queue_empty(&cores[v], round_robin)) continue;
+                        if (victim == -1 || cores[v].queued_work > cores[victim].queued_work) victim = v;
+                    }
+                    if (victim == -1) continue;
+                    p = core_pop(t, &cores[victim], round_robin, true);
+                    core->steals++;
+                    migrations++;
+                } else {
+                    continue;
+                }
+
+                int exec_time = t->remaining_time[p];
+                if (round_robin && exec_time > timeQuantum) exec_time = timeQuantum;
+
+                if (core->idle_since < current_time) {
+                    report_slice(&report, c, core->idle_since, current_time, -1);
+                }
+                report_slice(&report, c, current_time, current_time + exec_time, p);
+
+                if (t->start_time[p] == -1) {
+                    t->start_time[p] = current_time;
+                }
+                core->running = p;
+                core->slice_start = current_time;
+                core->slice_end = current_time + exec_time;
+            }
+        }
+
+        // Advance to the next arrival or slice end
+        long long next_event = next_arrival < n ? t->arrival_time[t->by_arrival[next_arrival]] : LLONG_MAX;
+        for (int c = 0; c < ncores; c++) {
+            if (cores[c].running != -1 && cores[c].slice_end < next_event) {
+                next_event = cores[c].slice_end;
+            }
+        }
+        if (next_event == LLONG_MAX) break;
+
+        simulate_time(next_event - current_time);
+        current_time = next_event;
+    }
+
+    report_summary(&report, "Placement", "", "%s",
+                   sched_options.placement == PLACE_AFFINITY ? "Affinity" : "Least Loaded");
+    for (int c = 0; c < ncores; c++) {
+        char label[32];
+        snprintf(label, sizeof(label), "Core %d Utilization", c);
+        double utilization = current_time > 0 ? 100.0 * cores[c].busy_time / current_time : 0;
+        report_summary(&report, label, "%", "%.2f", utilization);
+        snprintf(label, sizeof(label), "Core %d Stolen", c);
+        report_summary(&report, label, "", "%d", cores[c].steals);
+    }
+    report_summary(&report, "Migrations", "", "%d", migrations);
+    report_summary(&report, "Makespan", " time units", "%d", current_time);
+    report_summary(&report, "Average Waiting Time", " time units", "%.2f", total_waiting_time / n);
+    report_end(&report);
+
+    for (int c = 0; c < ncores; c++) {
+        if (round_robin) {
+            free_queue(&cores[c].queue);
+            free_queue(&cores[c].pending);
+        } else {
+            free_heap(&cores[c].heap);
+        }
+    }
+    free(cores);
+    free(ready);
+}
+
+// Online scheduling of a stream whose records come in arrival order. The engine
+// reads one record ahead and admits it once the clock reaches its arrival time;
+// a finished process gives its row back to the table, so memory follows the
+// number of waiting processes, not the length of the stream. For a stream in
+// arrival order the report is the same as the one for the whole file.
+void schedule_online(ProcessTable *t, StreamReader *s, Algorithm alg, int timeQuantum) {
+    Policy policy;
+    init_classic_policy(&policy, t, alg, timeQuantum);
+
+    ArrivalSource src = { .table = t, .cursor = 0, .stream = s, .next = -1 };
+    src.next = read_next_process(s, t);
+    run_policy(&policy, &src);
+
+    free_policy(&policy);
+}
+
+// Run the single selected algorithm online over a file, FIFO or "-" for standard input
+void run_online(const char *path, int timeQuantum) {
+    if (sched_options.algorithm_count != 1 || sched_options.algorithms[0] > ALG_PREEMPTIVE_PRIORITY ||
+        sched_options.cores > 0 || sched_options.parallel || sched_options.execute ||
+        sched_options.sweep_count > 0) {
+        fprintf(stderr, "Error: --online runs exactly one of fcfs, sjf, priority, rr, srtf or preemptive-priority, "
+                        "and cannot be combined with --cores, --parallel, --execute or --sweep\n");
+        return;
+    }
+
+    StreamReader stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.name = strcmp(path, "-") == 0 ? "stdin" : path;
+    stream.last_arrival = INT_MIN;
+    stream.fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+    if (stream.fd == -1) {
+        perror("Error opening file");
+        return;
+    }
+    stream.capacity = STREAM_BUFFER_SIZE;
+    stream.buf = malloc(stream.capacity);
+
+    ProcessTable processes;
+    init_process_table(&processes);
+    processes.recycle_rows = true;
+
+    if (!stream.buf) {
+        fprintf(stderr, "Error: Out of memory\n");
+    } else {
+        if (sched_options.format == FORMAT_CSV) {
+            output_string("algorithm,core,start,end,process\n");
+        }
+        schedule_online(&processes, &stream, sched_options.algorithms[0], timeQuantum);
+    }
+
+    free(stream.buf);
+    if (stream.fd != STDIN_FILENO) close(stream.fd);
+    free_process_table(&processes);
+}
+
+// Parse a comma-separated list of algorithm names, e.g. "fcfs,srtf,rr"
+int parse_algorithm_list(const char *list) {
+    Algorithm algorithms[ALG_COUNT];
+    int count = 0;
+
+    while (*list) {
+        size_t len = strcspn(list, ",");
+        int found = -1;
+        for (int alg = 0; alg < ALG_COUNT; alg++) {
+            if (strlen(algorithm_names[alg]) == len && strncmp(list, algorithm_names[alg], len) == 0) {
+                found = alg;
+            }
+        }
+        if (found < 0 || count == ALG_COUNT) return 0;
+
+        algorithms[count++] = found;
+        list += len;
+        if (*list == ',') list++;
+    }
+    if (count == 0) return 0;
+
+    memcpy(sched_options.algorithms, algorithms, sizeof(algorithms));
+    sched_options.algorithm_count = count;
+    return 1;
+}
+
+// Parse a positive integer option value, returns 0 if it is not one
+int parse_positive(const char *value, int *out) {
+    return parse_int_field(value, strlen(value), out) && *out > 0;
+}
+
+// Parse "--mlfq-quanta=2,4,8": one quantum per level, which also sets the level count
+int parse_mlfq_quanta(const char *list) {
+    int quanta[MLFQ_MAX_LEVELS];
+    int count = 0;
+
+    while (*list) {
+        size_t len = strcspn(list, ",");
+        if (count == MLFQ_MAX_LEVELS || !parse_int_field(list, len, &quanta[count]) || quanta[count] <= 0) {
+            return 0;
+        }
+        count++;
+        list += len;
+        if (*list == ',') list++;
+    }
+    if (count == 0) return 0;
+
+    memset(sched_options.mlfq_quanta, 0, sizeof(sched_options.mlfq_quanta));
+    memcpy(sched_options.mlfq_quanta, quanta, sizeof(int) * count);
+    sched_options.mlfq_levels = count;
+    return 1;
+}
+
+// Parse "--sweep=1-8,12,16": quanta given one by one or as inclusive ranges
+int parse_sweep_quanta(const char *list) {
+    int count = 0;
+
+    while (*list) {
+        size_t len = strcspn(list, ",");
+        size_t dash = strcspn(list, "-");
+        int low, high;
+
+        if (dash < len) {
+            if (!parse_int_field(list, dash, &low) ||
+                !parse_int_field(list + dash + 1, len - dash - 1, &high)) return 0;
+        } else {
+            if (!parse_int_field(list, len, &low)) return 0;
+            high = low;
+        }
+        if (low <= 0 || high < low || high - low >= SWEEP_MAX_QUANTA - count) return 0;
+
+        for (int q = low; q <= high; q++) {
+            sched_options.sweep_quanta[count++] = q;
+        }
+        list += len;
+        if (*list == ',') list++;
+    }
+
+    sched_options.sweep_count = count;
+    return count > 0;
+}
+
+// Parse "--time-unit=10us": a positive count with an s, ms, us or ns suffix
+int parse_time_unit(const char *value) {
+    static const struct { const char *suffix; long long ns; } units[] = {
+        { "ns", 1 }, { "us", 1000 }, { "ms", 1000000 }, { "s", 1000000000LL }
+    };
+
+    size_t digits = strspn(value, "0123456789");
+    int count;
+    if (digits == 0 || !parse_int_field(value, digits, &count) || count <= 0) return 0;
+
+    for (size_t u = 0; u < sizeof(units) / sizeof(units[0]); u++) {
+        if (strcmp(value + digits, units[u].suffix) == 0) {
+            sched_options.time_unit_ns = count * units[u].ns;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Parse one optional "--name=value" scheduler argument, returns 0 if it is not recognized
+int parse_scheduler_option(const char *arg) {
+    if (strcmp(arg, "--clock=virtual") == 0) {
+        sched_options.clock = CLOCK_VIRTUAL;
+        return 1;
+    }
+    if (strcmp(arg, "--clock=paced") == 0) {
+        sched_options.clock = CLOCK_PACED;
+        return 1;
+    }
+    if (strncmp(arg, "--format=", 9) == 0) {
+        const char *format = arg + 9;
+        if (strcmp(format, "human") == 0) {
+            sched_options.format = FORMAT_HUMAN;
+        } else if (strcmp(format, "csv") == 0) {
+            sched_options.format = FORMAT_CSV;
+        } else if (strcmp(format, "json") == 0) {
+            sched_options.format = FORMAT_JSON;
+        } else if (strcmp(format, "summary") == 0) {
+            sched_options.format = FORMAT_SUMMARY;
+        } else {
+            return 0;
+        }
+        return 1;
+    }
+    if (strncmp(arg, "--sweep=", 8) == 0) {
+        return parse_sweep_quanta(arg + 8);
+    }
+    if (strcmp(arg, "--sweep-metric=waiting") == 0) {
+        sched_options.sweep_metric = SWEEP_WAITING;
+        return 1;
+    }
+    if (strcmp(arg, "--sweep-metric=turnaround") == 0) {
+        sched_options.sweep_metric = SWEEP_TURNAROUND;
+        return 1;
+    }
+    if (strcmp(arg, "--sweep-metric=switches") == 0) {
+        sched_options.sweep_metric = SWEEP_SWITCHES;
+        return 1;
+    }
+    if (strcmp(arg, "--online") == 0) {
+        sched_options.online = true;
+        return 1;
+    }
+    if (strcmp(arg, "--execute") == 0) {
+        sched_options.execute = true;
+        return 1;
+    }
+    if (strncmp(arg, "--seed=", 7) == 0) {
+        char *end;
+        errno = 0;
+        sched_options.seed = strtoull(arg + 7, &end, 10);
+        return end != arg + 7 && *end == '\0' && errno == 0;
+    }
+    if (strcmp(arg, "--stats") == 0) {
+        sched_options.stats = true;
+        return 1;
+    }
+    if (strcmp(arg, "--metrics") == 0) {
+        sched_options.metrics = true;
+        return 1;
+    }
+    if (strncmp(arg, "--time-unit=", 12) == 0) {
+        return parse_time_unit(arg + 12);
+    }
+    if (strcmp(arg, "--parallel") == 0) {
+        sched_options.parallel = true;
+        return 1;
+    }
+    if (strncmp(arg, "--algorithms=", 13) == 0) {
+        return parse_algorithm_list(arg + 13);
+    }
+    if (strncmp(arg, "--mlfq-levels=", 14) == 0) {
+        int levels;
+        if (!parse_positive(arg + 14, &levels) || levels > MLFQ_MAX_LEVELS) return 0;
+        sched_options.mlfq_levels = levels;
+        return 1;
+    }
+    if (strncmp(arg, "--mlfq-quanta=", 14) == 0) {
+        return parse_mlfq_quanta(arg + 14);
+    }
+    if (strncmp(arg, "--cores=", 8) == 0) {
+        return parse_positive(arg + 8, &sched_options.cores) && sched_options.cores <= MAX_CORES;
+    }
+    if (strcmp(arg, "--placement=least-loaded") == 0) {
+        sched_options.placement = PLACE_LEAST_LOADED;
+        return 1;
+    }
+    if (strcmp(arg, "--placement=affinity") == 0) {
+        sched_options.placement = PLACE_AFFINITY;
+        return 1;
+    }
+    if (strncmp(arg, "--mlfq-boost=", 13) == 0) {
+        return parse_int_field(arg + 13, strlen(arg + 13), &sched_options.mlfq_boost) &&
+               sched_options.mlfq_boost >= 0;
+    }
+    return 0;
+}
+
+void run_algorithm(Algorithm alg, ProcessTable *t, int timeQuantum) {
+    if (sched_options.cores > 0) {
+        schedule_multicore(t, alg, timeQuantum);
+        flush_output();
+        return;
+    }
+
+    switch (alg) {
+        case ALG_FCFS:
+            schedule_fcfs(t);
+            break;
+        case ALG_SJF:
+            schedule_sjf(t);
+            break;
+        case ALG_PRIORITY:
+            schedule_priority(t);
+            break;
+        case ALG_ROUND_ROBIN:
+            schedule_round_robin(t, timeQuantum);
+            break;
+        case ALG_SRTF:
+            schedule_srtf(t);
+            break;
+        case ALG_PREEMPTIVE_PRIORITY:
+            schedule_preemptive_priority(t);
+            break;
+        case ALG_MLFQ:
+            schedule_mlfq(t, timeQuantum);
+            break;
+        case ALG_LOTTERY:
+            schedule_lottery(t, timeQuantum);
+            break;
+        case ALG_STRIDE:
+            schedule_stride(t, timeQuantum);
+            break;
+        default:
+            break;
+    }
+    flush_output();  // Ensure clean output between algorithms
+}
+
+// Copy everything written to a worker's private output file to our stdout
+int copy_worker_output(FILE *out) {
+    char buf[1 << 16];
+    ssize_t bytes_read;
+
+    if (lseek(fileno(out), 0, SEEK_SET) == -1) return 0;
+    while ((bytes_read = read(fileno(out), buf, sizeof(buf))) > 0) {
+        ssize_t written = 0;
+        while (written < bytes_read) {
+            ssize_t w = write(STDOUT_FILENO, buf + written, bytes_read - written);
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0) return 0;
+            written += w;
+        }
+    }
+    return bytes_read == 0;
+}
+
+// Run every selected algorithm at once, each in a forked child whose stdout is
+// a private temporary file. The reports are copied out in the fixed order once
+// all children are done, so the output matches a serial run.
+void run_algorithms_parallel(ProcessTable *t, int timeQuantum) {
+    int count = sched_options.algorithm_count;
+    FILE *out[ALG_COUNT];
+    pid_t pid[ALG_COUNT];
+
+    // Flush before forking so no child inherits (and repeats) buffered output
+    flush_output();
     fflush(stdout);
+    fflush(stderr);
+
+    for (int k = 0; k < count; k++) {
+        out[k] = tmpfile();
+        pid[k] = out[k] ? fork() : -1;
+
+        if (pid[k] == 0) {
+            dup2(fileno(out[k]), STDOUT_FILENO);
+            run_algorithm(sched_options.algorithms[k], t, timeQuantum);
+            _exit(0);
+        }
+    }
+
+    for (int k = 0; k < count; k++) {
+        int status = 0;
+
+        if (pid[k] < 0) {
+            // No worker could be started for this one, run it here instead
+            run_algorithm(sched_options.algorithms[k], t, timeQuantum);
+        } else if (waitpid(pid[k], &status, 0) == -1 || !WIFEXITED(status) ||
+                   WEXITSTATUS(status) != 0 || !copy_worker_output(out[k])) {
+            fprintf(stderr, "Error: Scheduler worker for %s failed\n",
+                    algorithm_names[sched_options.algorithms[k]]);
+        }
+
+        if (out[k]) fclose(out[k]);
+    }
+}
+
+// Outcome of one Round Robin run of the quantum sweep
+typedef struct {
+    double avg_waiting;
+    double avg_turnaround;
+    long long context_switches;
+} SweepResult;
+
+void run_sweep_quantum(ProcessTable *t, int quantum, SweepResult *result) {
+    result->context_switches = schedule_round_robin(t, quantum);
+
+    double total_waiting = 0, total_turnaround = 0;
+    for (int i = 0; i < t->count; i++) {
+        total_waiting += t->waiting_time[i];
+        total_turnaround += t->completion_time[i] - t->arrival_time[i];
+    }
+    result->avg_waiting = total_waiting / t->count;
+    result->avg_turnaround = total_turnaround / t->count;
+}
+
+double sweep_score(const SweepResult *result) {
+    switch (sched_options.sweep_metric) {
+        case SWEEP_TURNAROUND: return result->avg_turnaround;
+        case SWEEP_SWITCHES: return (double)result->context_switches;
+        default: return result->avg_waiting;
+    }
+}
+
+// Run Round Robin once per quantum of --sweep on the already parsed table and
+// print one comparison table. The runs are split across one forked worker per
+// online CPU, which store their results in a shared anonymous mapping.
+void run_quantum_sweep(ProcessTable *t) {
+    int count = sched_options.sweep_count;
+    size_t size = sizeof(SweepResult) * count;
+    SweepResult *results = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (results == MAP_FAILED) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return;
+    }
+
+    // The runs only produce numbers: no report and no real-time pacing
+    OutputFormat format = sched_options.format;
+    ClockMode clock = sched_options.clock;
+    bool metrics = sched_options.metrics;
+    sched_options.format = FORMAT_NONE;
+    sched_options.clock = CLOCK_VIRTUAL;
+    sched_options.metrics = false;
 
-    schedule_priority(processes, n);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int workers = cpus > 1 ? (int)(cpus < count ? cpus : count) : 1;
+    pid_t pid[workers];
+    int started = 0;
+
+    flush_output();
     fflush(stdout);
+    fflush(stderr);
+
+    for (int w = 0; w < workers && workers > 1; w++) {
+        pid[w] = fork();
+        if (pid[w] == 0) {
+            for (int k = w; k < count; k += workers) {
+                run_sweep_quantum(t, sched_options.sweep_quanta[k], &results[k]);
+            }
+            _exit(0);
+        }
+        if (pid[w] < 0) break;
+        started++;
+    }
+
+    // Whatever the workers did not cover (all of it when none could be started) runs here
+    bool failed = false;
+    for (int w = 0; w < started; w++) {
+        int status = 0;
+        if (waitpid(pid[w], &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed = true;
+        }
+    }
+    for (int k = 0; k < count; k++) {
+        if (started == 0 || failed || k % workers >= started) {
+            run_sweep_quantum(t, sched_options.sweep_quanta[k], &results[k]);
+        }
+    }
+
+    sched_options.format = format;
+    sched_options.clock = clock;
+    sched_options.metrics = metrics;
+
+    int best = 0;
+    for (int k = 1; k < count; k++) {
+        if (sweep_score(&results[k]) < sweep_score(&results[best])) best = k;
+    }
+
+    const char *metric_names[] = { "waiting", "turnaround", "switches" };
+    const char *metric = metric_names[sched_options.sweep_metric];
+
+    switch (sched_options.format) {
+        case FORMAT_CSV:
+            output_string("quantum,avg_waiting,avg_turnaround,context_switches,best\n");
+            for (int k = 0; k < count; k++) {
+                output_format("%d,%.2f,%.2f,%lld,%d\n", sched_options.sweep_quanta[k], results[k].avg_waiting,
+                              results[k].avg_turnaround, results[k].context_switches, k == best);
+            }
+            break;
+        case FORMAT_JSON:
+            output_format("{\"sweep\":\"rr\",\"metric\":\"%s\",\"best_quantum\":%d,\"quanta\":[",
+                          metric, sched_options.sweep_quanta[best]);
+            for (int k = 0; k < count; k++) {
+                output_format("%s{\"quantum\":%d,\"avg_waiting\":%.2f,\"avg_turnaround\":%.2f,"
+                              "\"context_switches\":%lld}", k > 0 ? "," : "", sched_options.sweep_quanta[k],
+                              results[k].avg_waiting, results[k].avg_turnaround, results[k].context_switches);
+            }
+            output_string("]}\n");
+            break;
+        default:
+            output_string("══════════════════════════════════════════════\n");
+            output_string(">> Scheduler Mode : Round Robin Quantum Sweep\n");
+            output_format(">> Processes      : %d\n", t->count);
+            output_string("──────────────────────────────────────────────\n\n");
+            output_string(" Quantum   Avg Waiting   Avg Turnaround   Context Switches\n");
+            for (int k = 0; k < count; k++) {
+                output_format(" %7d   %11.2f   %14.2f   %16lld%s\n", sched_options.sweep_quanta[k],
+                              results[k].avg_waiting, results[k].avg_turnaround,
+                              results[k].context_switches, k == best ? "  <- best" : "");
+            }
+            output_string("\n──────────────────────────────────────────────\n");
+            output_format(">> Best Quantum   : %d (lowest %s)\n", sched_options.sweep_quanta[best],
+                          sched_options.sweep_metric == SWEEP_SWITCHES ? "context switches" :
+                          sched_options.sweep_metric == SWEEP_TURNAROUND ? "average turnaround time" :
+                          "average waiting time");
+            output_string(">> End of Report\n");
+            output_string("══════════════════════════════════════════════\n\n");
+            break;
+    }
 
-    schedule_round_robin(processes, n, timeQuantum);
+    flush_output();
+    munmap(results, size);
+}
+
+// Main CPU Scheduler function
+void runCPUScheduler(char* processesCsvFilePath, int timeQuantum) {
+    if (sched_options.online) {
+        run_online(processesCsvFilePath, timeQuantum);
+        return;
+    }
+
+    ProcessTable processes;
+    init_process_table(&processes);
+    long long parse_start = monotonic_ns();
+    int n = read_processes(processesCsvFilePath, &processes);
+    bool sorted = n > 0 && sort_by_arrival(&processes);
+    parse_ns = monotonic_ns() - parse_start;
+
+    if (!sorted) {
+        fprintf(stderr, "Error: Could not read processes from file\n");
+        free_process_table(&processes);
+        return;
+    }
+
+    // The multi-core engine only models the four classic algorithms
+    for (int k = 0; k < sched_options.algorithm_count && sched_options.cores > 0; k++) {
+        if (sched_options.algorithms[k] > ALG_ROUND_ROBIN) {
+            fprintf(stderr, "Error: --cores supports only fcfs, sjf, priority and rr\n");
+            free_process_table(&processes);
+            return;
+        }
+    }
+
+    // Real processes need the paced clock and the CPU to themselves
+    if (sched_options.execute &&
+        (sched_options.clock != CLOCK_PACED || sched_options.cores > 0 || sched_options.parallel ||
+         sched_options.sweep_count > 0)) {
+        fprintf(stderr, "Error: --execute needs the paced clock and cannot be combined with "
+                        "--cores, --parallel or --sweep\n");
+        free_process_table(&processes);
+        return;
+    }
+
+    // Flush output to prevent buffering issues that cause duplication
     fflush(stdout);
+    fflush(stderr);
+
+    if (sched_options.sweep_count > 0) {
+        run_quantum_sweep(&processes);
+        free_process_table(&processes);
+        return;
+    }
+
+    // CSV output is one table: a single header row for every report
+    if (sched_options.format == FORMAT_CSV) {
+        output_string("algorithm,core,start,end,process\n");
+    }
+
+    // Run the selected scheduling algorithms (all four classic ones by default)
+    if (sched_options.parallel) {
+        run_algorithms_parallel(&processes, timeQuantum);
+    } else {
+        for (int k = 0; k < sched_options.algorithm_count; k++) {
+            run_algorithm(sched_options.algorithms[k], &processes, timeQuantum);
+        }
+    }
+
+    free_process_table(&processes);
 }
\ No newline at end of file
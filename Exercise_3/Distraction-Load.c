@@ -0,0 +1,158 @@
+// Distraction load generator for Focus Mode.
+// Forks K producers that send distraction signals to a running Focus Mode at a
+// fixed rate, so signal delivery is measured across processes and under load.
+//
+//   gcc Distraction-Load.c -o distraction-load
+//   ./ex3 Focus-Mode 5 1000000 --script --realtime --load=/tmp/focus.load < events.txt
+//   ./distraction-load /tmp/focus.load --producers=4 --rate=5000 --duration=2
+//
+// Focus Mode publishes its pid and signal mode in the --load file; the producers
+// count what they send in the same file, and every round report compares it
+// with what arrived.
+#include "Focus-Mode.c"
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define MAX_PRODUCERS 256
+#define ATTACH_TIMEOUT_MS 10000
+
+typedef struct {
+    int producers;
+    double rate;        // Signals per second per producer, 0 for as fast as possible
+    double duration;    // Seconds
+} LoadOptions;
+
+long long load_clock_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+void print_usage(const char *program) {
+    fprintf(stderr, "Usage: %s <counters-file> [--producers=K] [--rate=R] [--duration=S]\n", program);
+    exit(1);
+}
+
+int parse_option(const char *arg, LoadOptions *opt) {
+    if (strncmp(arg, "--producers=", 12) == 0) {
+        opt->producers = atoi(arg + 12);
+        return opt->producers >= 1 && opt->producers <= MAX_PRODUCERS;
+    }
+    if (strncmp(arg, "--rate=", 7) == 0) {
+        opt->rate = atof(arg + 7);
+        return opt->rate >= 0;
+    }
+    if (strncmp(arg, "--duration=", 11) == 0) {
+        opt->duration = atof(arg + 11);
+        return opt->duration > 0;
+    }
+    return 0;
+}
+
+// Send distractions until the duration is over or Focus Mode stops listening.
+// Producer k starts with distraction type k, so all three types see the same load.
+void run_producer(LoadCounters *counters, int k, const LoadOptions *opt) {
+    long long start = load_clock_ns();
+    long long end = start + (long long)(opt->duration * 1e9);
+    double interval = opt->rate > 0 ? 1e9 / opt->rate : 0;
+
+    for (long i = 0;; i++) {
+        // Absolute deadlines: a late send is not made up for by the sleeps after it
+        long long deadline = start + (long long)(i * interval);
+        if (deadline >= end) break;
+        if (interval > 0) {
+            struct timespec at = { deadline / 1000000000LL, deadline % 1000000000LL };
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &at, NULL) == EINTR);
+        } else if (load_clock_ns() >= end) {
+            break;
+        }
+
+        // Stay counted as active from reading target until the send is counted, so
+        // Focus Mode can wait for sends in flight after it clears target
+        __atomic_fetch_add(&counters->active, 1, __ATOMIC_SEQ_CST);
+        pid_t target = __atomic_load_n(&counters->target, __ATOMIC_SEQ_CST);
+        int result = -1;
+        int type = (k + i) % DISTRACTION_TYPES;
+        if (target > 0) {
+            if (counters->realtime) {
+                union sigval value;
+                value.sival_int = focus_clock_us();
+                result = sigqueue(target, SIGRTMIN + type, value);
+            } else {
+                int signals[DISTRACTION_TYPES] = { EMAIL_SIGNAL, DELIVERY_SIGNAL, DOORBELL_SIGNAL };
+                result = kill(target, signals[type]);
+            }
+
+            if (result == 0) {
+                __atomic_fetch_add(&counters->sent[type], 1, __ATOMIC_RELAXED);
+            } else if (errno == EAGAIN) {
+                __atomic_fetch_add(&counters->rejected[type], 1, __ATOMIC_RELAXED);
+            }
+        }
+        bool stop = target <= 0 || (result == -1 && errno == ESRCH);
+        __atomic_fetch_sub(&counters->active, 1, __ATOMIC_SEQ_CST);
+        if (stop) break;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    LoadOptions opt = {
+        .producers = 1,
+        .rate = 1000,
+        .duration = 1,
+    };
+
+    if (argc < 2) print_usage(argv[0]);
+    for (int i = 2; i < argc; i++) {
+        if (!parse_option(argv[i], &opt)) print_usage(argv[0]);
+    }
+
+    // Wait for Focus Mode to create the file and publish its pid
+    LoadCounters *counters = MAP_FAILED;
+    for (int waited = 0; waited < ATTACH_TIMEOUT_MS; waited += 10) {
+        int fd = open(argv[1], O_RDWR);
+        struct stat st;
+        if (fd != -1 && fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(LoadCounters)) {
+            counters = mmap(NULL, sizeof(LoadCounters), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (fd != -1) close(fd);
+        if (counters != MAP_FAILED && __atomic_load_n(&counters->target, __ATOMIC_ACQUIRE) > 0) break;
+        if (counters != MAP_FAILED) {
+            munmap(counters, sizeof(LoadCounters));
+            counters = MAP_FAILED;
+        }
+        struct timespec pause = { 0, 10000000 };
+        nanosleep(&pause, NULL);
+    }
+    if (counters == MAP_FAILED) {
+        fprintf(stderr, "Error: no Focus Mode is listening on %s\n", argv[1]);
+        return 1;
+    }
+
+    long long start = load_clock_ns();
+    for (int k = 0; k < opt.producers; k++) {
+        pid_t pid = fork();
+        if (pid == -1) {
+            perror("Error forking producer");
+            break;
+        }
+        if (pid == 0) {
+            run_producer(counters, k, &opt);
+            _exit(0);
+        }
+    }
+    while (wait(NULL) > 0);
+    double seconds = (load_clock_ns() - start) / 1e9;
+
+    long sent = 0, rejected = 0;
+    for (int i = 0; i < DISTRACTION_TYPES; i++) {
+        sent += counters->sent[i];
+        rejected += counters->rejected[i];
+    }
+    printf("Sent %ld %s distractions from %d producers in %.3f s (%.0f per second), %ld more rejected as queue full\n",
+           sent, counters->realtime ? "real-time" : "standard", opt.producers, seconds,
+           seconds > 0 ? sent / seconds : 0, rejected);
+
+    munmap(counters, sizeof(LoadCounters));
+    return 0;
+}
@@ -1,8 +1,17 @@
 // Adir Tamam 318936507
 #include <stdio.h>
+#include <stdlib.h>
 #include <signal.h>
 #include <unistd.h>
 #include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
 
 // Global variables to track which signals were received
 volatile sig_atomic_t email_received = 0;
@@ -14,6 +23,79 @@ volatile sig_atomic_t doorbell_received = 0;
 #define DELIVERY_SIGNAL SIGUSR2
 #define DOORBELL_SIGNAL SIGTERM
 
+#define SCRIPT_BUFFER_SIZE (1 << 16)
+#define DISTRACTION_TYPES 3
+#define TIMESTAMP_MASK 0x7fffffff   // Real-time payloads carry microseconds modulo 2^31, about 35 minutes
+#define SIGNALFD_BATCH 64
+#define LOAD_STOP_TIMEOUT_MS 1000
+
+// Optional Focus Mode settings, given after the round duration
+typedef struct {
+    bool script;    // Replay an event script from stdin: no menu, input read in large blocks
+    bool realtime;  // Queue every distraction as a real-time signal carrying its send time
+    const char *load_path;  // Counters file shared with the Distraction-Load generator
+    bool timed;     // A round lasts the round duration in milliseconds instead of that many inputs
+} FocusOptions;
+
+FocusOptions focus_options = {
+    .script = false,
+    .realtime = false,
+    .load_path = NULL,
+    .timed = false,
+};
+
+// Layout of the --load counters file. Focus Mode publishes its pid and signal
+// mode; every producer of Distraction-Load adds what it sent, atomically.
+typedef struct {
+    pid_t target;
+    int realtime;
+    int active;             // Producers between reading target and counting their send
+    long sent[DISTRACTION_TYPES];       // Accepted by the kernel
+    long rejected[DISTRACTION_TYPES];   // sigqueue() failed, the queue was full; not in sent
+} LoadCounters;
+
+// Focus Mode's side of the load: what came from other processes
+typedef struct {
+    LoadCounters *counters;     // Mapped --load file, NULL without --load
+    long sent_before;           // Sent total at the last report
+    long received;              // This round
+    long total_received;
+    int *delays;                // Queueing delays of this round's real-time signals, in microseconds
+    int delay_count, delay_capacity;
+} LoadTracker;
+
+LoadTracker load;
+
+// What one round's queued real-time signals of a distraction type looked like
+typedef struct {
+    long received;
+    long dropped;           // sigqueue() failed, the queue was full
+    int first_sent, last_sent;  // Microseconds after the round started
+    long long delay_sum;    // Microseconds from sending until the signal was taken
+    int delay_max;
+} DistractionStats;
+
+DistractionStats distraction_stats[DISTRACTION_TYPES];
+int round_start_us;
+
+// Event script read from stdin one block at a time
+typedef struct {
+    char buf[SCRIPT_BUFFER_SIZE];
+    size_t start, used;     // Unread bytes are buf[start, used)
+    bool eof;
+    bool in_line;           // The event of the current line was taken, the rest is skipped
+} ScriptReader;
+
+ScriptReader script;
+
+// Descriptors of the --timed event loop
+typedef struct {
+    int epoll_fd, signal_fd, timer_fd;
+    bool stdin_polled;      // false for a regular file, which epoll cannot watch but never blocks
+} TimedLoop;
+
+sigset_t taken_distractions;    // Read from the signalfd during a timed round, no longer pending
+
 // Signal handler function
 void distraction_handler(int signum) {
     switch(signum) {
@@ -29,6 +111,38 @@ void distraction_handler(int signum) {
     }
 }
 
+// Position of a distraction in the report order: email, delivery, doorbell
+int distraction_index(int signum) {
+    return signum == EMAIL_SIGNAL ? 0 : signum == DELIVERY_SIGNAL ? 1 : 2;
+}
+
+// The signal a distraction is sent as: SIGRTMIN+0..2 instead of the standard ones with --realtime
+int distraction_signal(int signum) {
+    return focus_options.realtime ? SIGRTMIN + distraction_index(signum) : signum;
+}
+
+// CLOCK_MONOTONIC in microseconds, wrapped to fit the int payload of sigqueue()
+int focus_clock_us() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int)((now.tv_sec * 1000000LL + now.tv_nsec / 1000) & TIMESTAMP_MASK);
+}
+
+// Send a distraction to ourselves. Real-time signals are queued, one per send,
+// with the send time as payload; standard ones coalesce while blocked.
+void send_distraction(int signum) {
+    if (!focus_options.realtime) {
+        kill(getpid(), signum);
+        return;
+    }
+
+    union sigval value;
+    value.sival_int = focus_clock_us();
+    if (sigqueue(getpid(), distraction_signal(signum), value) == -1 && errno == EAGAIN) {
+        distraction_stats[distraction_index(signum)].dropped++;
+    }
+}
+
 // Function to set up signal handlers using sigaction
 void setup_signal_handlers_Focus() {
     struct sigaction sa;
@@ -43,17 +157,32 @@ void setup_signal_handlers_Focus() {
     sigaction(EMAIL_SIGNAL, &sa, NULL);
     sigaction(DELIVERY_SIGNAL, &sa, NULL);
     sigaction(DOORBELL_SIGNAL, &sa, NULL);
+
+    if (focus_options.realtime) {
+        for (int i = 0; i < DISTRACTION_TYPES; i++) {
+            sigaction(SIGRTMIN + i, &sa, NULL);
+        }
+    }
+}
+
+// The signals distractions can arrive as, the real-time ones only with --realtime
+void fill_distractions(sigset_t *set) {
+    sigemptyset(set);
+    sigaddset(set, EMAIL_SIGNAL);
+    sigaddset(set, DELIVERY_SIGNAL);
+    sigaddset(set, DOORBELL_SIGNAL);
+    if (focus_options.realtime) {
+        for (int i = 0; i < DISTRACTION_TYPES; i++) {
+            sigaddset(set, SIGRTMIN + i);
+        }
+    }
 }
 
 // Function to block all distraction signals using sigprocmask
 void block_distractions(sigset_t *oldset) {
     sigset_t newset;
 
-    sigemptyset(&newset);
-    sigaddset(&newset, EMAIL_SIGNAL);
-    sigaddset(&newset, DELIVERY_SIGNAL);
-    sigaddset(&newset, DOORBELL_SIGNAL);
-
+    fill_distractions(&newset);
     sigprocmask(SIG_BLOCK, &newset, oldset);
 }
 
@@ -62,6 +191,145 @@ void unblock_distractions(sigset_t *oldset) {
     sigprocmask(SIG_SETMASK, oldset, NULL);
 }
 
+void record_load_delay(int delay) {
+    if (load.delay_count == load.delay_capacity) {
+        int capacity = load.delay_capacity > 0 ? load.delay_capacity * 2 : 1024;
+        int *grown = realloc(load.delays, sizeof(int) * capacity);
+        if (!grown) return;
+        load.delays = grown;
+        load.delay_capacity = capacity;
+    }
+    load.delays[load.delay_count++] = delay;
+}
+
+int compare_delays(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Totals of all producers so far
+void read_load_counters(long *sent, long *rejected) {
+    *sent = *rejected = 0;
+    for (int i = 0; i < DISTRACTION_TYPES; i++) {
+        *sent += __atomic_load_n(&load.counters->sent[i], __ATOMIC_RELAXED);
+        *rejected += __atomic_load_n(&load.counters->rejected[i], __ATOMIC_RELAXED);
+    }
+}
+
+// What the Distraction-Load producers sent since the last report against what reached
+// us. Standard signals coalesce while blocked, so most of their loss is expected.
+void print_load_report() {
+    long sent, rejected;
+    read_load_counters(&sent, &rejected);
+    long round_sent = sent - load.sent_before;
+    load.sent_before = sent;
+    load.total_received += load.received;
+
+    printf(" Load: sent %ld, received %ld, lost %ld", round_sent, load.received, round_sent - load.received);
+    if (rejected > 0) printf(" (%ld more rejected as queue full so far)", rejected);
+    printf("\n");
+
+    if (load.delay_count > 0) {
+        int *d = load.delays;
+        int n = load.delay_count;
+        qsort(d, n, sizeof(int), compare_delays);
+        printf(" Load delay: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+               d[(n - 1) * 50 / 100] / 1000.0, d[(n - 1) * 90 / 100] / 1000.0,
+               d[(n - 1) * 99 / 100] / 1000.0, d[n - 1] / 1000.0);
+    }
+    load.received = 0;
+    load.delay_count = 0;
+}
+
+// Create the --load counters file and publish our pid, returns 0 on failure
+int open_load_counters(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1 || ftruncate(fd, sizeof(LoadCounters)) == -1) {
+        perror("Error opening load counters");
+        if (fd != -1) close(fd);
+        return 0;
+    }
+    void *map = mmap(NULL, sizeof(LoadCounters), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("Error mapping load counters");
+        return 0;
+    }
+
+    load.counters = map;
+    load.counters->realtime = focus_options.realtime;
+    __atomic_store_n(&load.counters->target, getpid(), __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Account for one distraction taken while blocked: count it for the load if it came
+// from another process, and record a real-time signal's payload in distraction_stats
+void take_distraction(int signum, pid_t pid, int value) {
+    bool external = load.counters && pid != getpid();
+    if (external) load.received++;
+    if (signum < SIGRTMIN || signum >= SIGRTMIN + DISTRACTION_TYPES) return;
+
+    // Wrapping arithmetic keeps both offsets right across the 2^31 microsecond wrap;
+    // a signal queued before the round started gets a negative offset
+    DistractionStats *d = &distraction_stats[signum - SIGRTMIN];
+    int sent = (value - round_start_us) & TIMESTAMP_MASK;
+    if (sent > TIMESTAMP_MASK / 2) sent = sent - TIMESTAMP_MASK - 1;
+    int delay = (focus_clock_us() - value) & TIMESTAMP_MASK;
+    if (external) record_load_delay(delay);
+    if (d->received == 0) d->first_sent = sent;
+    d->last_sent = sent;
+    d->received++;
+    d->delay_sum += delay;
+    if (delay > d->delay_max) d->delay_max = delay;
+}
+
+// Accept every pending distraction without unblocking them. sigtimedwait() with a
+// zero timeout takes a pending signal synchronously, so no handler runs and there
+// is nothing to wait for; it fails with EAGAIN once none is left. Queued real-time
+// signals are taken one by one and their payloads go into distraction_stats.
+void drain_distractions() {
+    sigset_t distractions;
+    fill_distractions(&distractions);
+
+    struct timespec no_wait = { 0, 0 };
+    siginfo_t info;
+    while (1) {
+        int signum = sigtimedwait(&distractions, &info, &no_wait);
+        if (signum == -1) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        take_distraction(signum, info.si_pid, info.si_value.sival_int);
+    }
+}
+
+// Take a batch of distractions from the signalfd of a timed round. Reading them
+// consumes them like sigtimedwait() does, so they are remembered for the report.
+void read_signalfd(int fd) {
+    struct signalfd_siginfo info[SIGNALFD_BATCH];
+    ssize_t bytes_read;
+
+    do {
+        bytes_read = read(fd, info, sizeof(info));
+        for (int k = 0; k < bytes_read / (ssize_t)sizeof(info[0]); k++) {
+            sigaddset(&taken_distractions, info[k].ssi_signo);
+            take_distraction(info[k].ssi_signo, info[k].ssi_pid, info[k].ssi_int);
+        }
+    } while (bytes_read == sizeof(info));
+}
+
+// Counts and timings of a distraction's queued signals, printed under its report line
+void print_distraction_stats(int signum) {
+    DistractionStats *d = &distraction_stats[distraction_index(signum)];
+    if (!focus_options.realtime) return;
+
+    printf("   Received %ld, first sent at %+.3f ms, last at %+.3f ms, queueing delay avg %.3f ms, max %.3f ms",
+           d->received, d->first_sent / 1000.0, d->last_sent / 1000.0,
+           d->received > 0 ? d->delay_sum / 1000.0 / d->received : 0, d->delay_max / 1000.0);
+    if (d->dropped > 0) printf(", %ld dropped (queue full)", d->dropped);
+    printf("\n");
+}
+
 // Function to check and handle pending signals using sigpending and sigismember
 void check_pending_distractions() {
     sigset_t pending;
@@ -73,24 +341,41 @@ void check_pending_distractions() {
     // Get pending signals using sigpending
     sigpending(&pending);
 
+    // A timed round takes its distractions as they arrive; report them as pending
+    if (focus_options.timed) {
+        int signals[DISTRACTION_TYPES] = { EMAIL_SIGNAL, DELIVERY_SIGNAL, DOORBELL_SIGNAL };
+        for (int i = 0; i < DISTRACTION_TYPES; i++) {
+            if (sigismember(&taken_distractions, distraction_signal(signals[i]))) {
+                sigaddset(&pending, distraction_signal(signals[i]));
+            }
+        }
+        sigemptyset(&taken_distractions);
+    }
+
+    // Consume the pending signals while they stay blocked, so the next round starts clean
+    drain_distractions();
+
     int any_distractions = 0;
 
     // Check for each signal in order (1, 2, 3) using sigismember
-    if (sigismember(&pending, EMAIL_SIGNAL)) {
+    if (sigismember(&pending, distraction_signal(EMAIL_SIGNAL))) {
         any_distractions = 1;
         printf(" - Email notification is waiting.\n");
+        print_distraction_stats(EMAIL_SIGNAL);
         printf("[Outcome:] The TA announced: Everyone get 100 on the exercise!\n");
     }
 
-    if (sigismember(&pending, DELIVERY_SIGNAL)) {
+    if (sigismember(&pending, distraction_signal(DELIVERY_SIGNAL))) {
         any_distractions = 1;
         printf(" - You have a reminder to pick up your delivery.\n");
+        print_distraction_stats(DELIVERY_SIGNAL);
         printf("[Outcome:] You picked it up just in time.\n");
     }
 
-    if (sigismember(&pending, DOORBELL_SIGNAL)) {
+    if (sigismember(&pending, distraction_signal(DOORBELL_SIGNAL))) {
         any_distractions = 1;
         printf(" - The doorbell is ringing.\n");
+        print_distraction_stats(DOORBELL_SIGNAL);
         printf("[Outcome:] Food delivery is here.\n");
     }
 
@@ -98,23 +383,15 @@ void check_pending_distractions() {
         printf("No distractions reached you this round.\n");
     }
 
+    if (load.counters) {
+        print_load_report();
+    }
+
     printf("──────────────────────────────────────────────\n");
     printf("             Back to Focus Mode.              \n");
     printf("══════════════════════════════════════════════\n");
 
-    // Temporarily unblock signals to clear pending signals
-    sigset_t temp_unblock;
-    sigemptyset(&temp_unblock);
-    sigaddset(&temp_unblock, EMAIL_SIGNAL);
-    sigaddset(&temp_unblock, DELIVERY_SIGNAL);
-    sigaddset(&temp_unblock, DOORBELL_SIGNAL);
-    sigprocmask(SIG_UNBLOCK, &temp_unblock, NULL);
-
-    // Give a moment for signals to be delivered
-    usleep(1000);
-
-    // Block them again for the next round
-    sigprocmask(SIG_BLOCK, &temp_unblock, NULL);
+    memset(distraction_stats, 0, sizeof(distraction_stats));
 }
 
 // Function to simulate a single focus round
@@ -151,23 +428,271 @@ void run_focus_round(int round_num, int duration) {
         }
         else if (input_char == '1') {
             // Send email signal to self
-            kill(getpid(), EMAIL_SIGNAL);
+            send_distraction(EMAIL_SIGNAL);
         }
         else if (input_char == '2') {
             // Send delivery signal to self
-            kill(getpid(), DELIVERY_SIGNAL);
+            send_distraction(DELIVERY_SIGNAL);
         }
         else if (input_char == '3') {
             // Send doorbell signal to self
-            kill(getpid(), DOORBELL_SIGNAL);
+            send_distraction(DOORBELL_SIGNAL);
+        }
+    }
+}
+
+// First character of the next script line, the same character the interactive
+// prompt acts on, or -1 at the end of the script. The rest of the line is skipped.
+int next_script_event(ScriptReader *s) {
+    int event = -1;
+
+    while (1) {
+        if (s->start == s->used) {
+            if (s->eof) return event;
+            ssize_t bytes_read = read(STDIN_FILENO, s->buf, sizeof(s->buf));
+            if (bytes_read < 0 && errno == EINTR) continue;
+            if (bytes_read <= 0) {
+                s->eof = true;
+                return event;
+            }
+            s->start = 0;
+            s->used = bytes_read;
+        }
+
+        if (event == -1) {
+            event = (unsigned char)s->buf[s->start++];
+            if (event == '\n') return event;
+            continue;
+        }
+
+        char *newline = memchr(s->buf + s->start, '\n', s->used - s->start);
+        if (newline) {
+            s->start = newline - s->buf + 1;
+            return event;
         }
+        s->start = s->used;
     }
 }
 
+// Send the distraction of a script event. Standard signals of the same type do not
+// queue while blocked, so each one is sent at most once per round; `sent` holds the
+// ones already pending and is cleared after the round's report.
+void send_script_event(int event, sigset_t *sent) {
+    int signum = event == '1' ? EMAIL_SIGNAL :
+                 event == '2' ? DELIVERY_SIGNAL :
+                 event == '3' ? DOORBELL_SIGNAL : 0;
+    if (signum == 0) return;
+
+    // Real-time signals are all queued, so every one of them counts
+    if (focus_options.realtime) {
+        send_distraction(signum);
+    } else if (!sigismember(sent, signum)) {
+        kill(getpid(), signum);
+        sigaddset(sent, signum);
+    }
+}
+
+// A focus round replayed from the event script
+void run_script_round(int round_num, int duration, sigset_t *sent) {
+    printf("══════════════════════════════════════════════\n");
+    printf("                Focus Round %d                \n", round_num);
+    printf("──────────────────────────────────────────────\n");
+
+    for (int i = 0; i < duration; i++) {
+        int event = next_script_event(&script);
+        if (event == -1 || event == 'q') {
+            break;
+        }
+        send_script_event(event, sent);
+    }
+}
+
+// Act on the lines already in the script buffer, after reading one more block into
+// it if it is empty and may_read is set. Returns 'q' when a line ends the round,
+// -1 at the end of input and 0 once the buffer is used up. Lines may span reads.
+int take_timed_input(sigset_t *sent, bool may_read) {
+    ScriptReader *s = &script;
+
+    while (1) {
+        if (s->start == s->used) {
+            if (s->eof) return -1;
+            if (!may_read) return 0;
+            ssize_t bytes_read = read(STDIN_FILENO, s->buf, sizeof(s->buf));
+            if (bytes_read < 0 && errno == EINTR) return 0;
+            if (bytes_read <= 0) {
+                s->eof = true;
+                return -1;
+            }
+            s->start = 0;
+            s->used = bytes_read;
+            may_read = false;   // A second read could block
+        }
+
+        if (s->in_line) {
+            char *newline = memchr(s->buf + s->start, '\n', s->used - s->start);
+            s->start = newline ? (size_t)(newline - s->buf + 1) : s->used;
+            s->in_line = newline == NULL;
+            continue;
+        }
+
+        int event = (unsigned char)s->buf[s->start++];
+        s->in_line = event != '\n';
+        if (event == 'q') return 'q';
+        send_script_event(event, sent);
+    }
+}
+
+// A focus round that lasts duration_ms of real time, whatever the input does. One
+// epoll_wait() sleeps until input, a distraction or the end of the round, so a
+// quiet round uses no CPU; distractions are taken as they arrive and reported
+// together when the window closes.
+void run_timed_round(int round_num, int duration_ms, TimedLoop *loop, sigset_t *sent) {
+    printf("══════════════════════════════════════════════\n");
+    printf("                Focus Round %d                \n", round_num);
+    printf("──────────────────────────────────────────────\n");
+    fflush(stdout);
+
+    struct itimerspec window = { { 0, 0 }, { duration_ms / 1000, duration_ms % 1000 * 1000000L } };
+    timerfd_settime(loop->timer_fd, 0, &window, NULL);
+
+    // Input left over by a round that ended with 'q', or a regular file, which is
+    // never waited for: all of it is there already
+    int input = take_timed_input(sent, !loop->stdin_polled);
+    while (!loop->stdin_polled && input == 0) {
+        input = take_timed_input(sent, true);
+    }
+    bool over = input == 'q';
+
+    while (!over) {
+        struct epoll_event events[3];
+        int ready = epoll_wait(loop->epoll_fd, events, 3, -1);
+        if (ready == -1) {
+            if (errno == EINTR) continue;
+            perror("Error waiting for events");
+            break;
+        }
+
+        for (int k = 0; k < ready; k++) {
+            int fd = events[k].data.fd;
+            if (fd == loop->timer_fd) {
+                over = true;
+            } else if (fd == loop->signal_fd) {
+                read_signalfd(fd);
+            } else {
+                input = take_timed_input(sent, true);
+                if (input == 'q') over = true;
+                if (input == -1) {
+                    // Stop watching a closed stdin, the remaining rounds run on the timer alone
+                    epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+                    loop->stdin_polled = false;
+                }
+            }
+        }
+    }
+
+    // Distractions that arrived in the same instant are still this round's
+    read_signalfd(loop->signal_fd);
+
+    struct itimerspec disarm = { { 0, 0 }, { 0, 0 } };
+    timerfd_settime(loop->timer_fd, 0, &disarm, NULL);
+}
+
+// Create the signalfd, round timer and epoll set of --timed, returns 0 on failure.
+// The distractions must already be blocked, or they would not reach the signalfd.
+int open_timed_loop(TimedLoop *loop) {
+    sigset_t distractions;
+    fill_distractions(&distractions);
+    sigemptyset(&taken_distractions);
+
+    loop->signal_fd = signalfd(-1, &distractions, SFD_NONBLOCK | SFD_CLOEXEC);
+    loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->signal_fd == -1 || loop->timer_fd == -1 || loop->epoll_fd == -1) {
+        perror("Error creating the event loop");
+        return 0;
+    }
+
+    int fds[3] = { loop->signal_fd, loop->timer_fd, STDIN_FILENO };
+    for (int k = 0; k < 3; k++) {
+        struct epoll_event event = { .events = EPOLLIN, .data.fd = fds[k] };
+        if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fds[k], &event) == -1) {
+            if (fds[k] == STDIN_FILENO && errno == EPERM) break;
+            perror("Error creating the event loop");
+            return 0;
+        }
+        if (fds[k] == STDIN_FILENO) loop->stdin_polled = true;
+    }
+    return 1;
+}
+
+void close_timed_loop(TimedLoop *loop) {
+    if (loop->epoll_fd != -1) close(loop->epoll_fd);
+    if (loop->timer_fd != -1) close(loop->timer_fd);
+    if (loop->signal_fd != -1) close(loop->signal_fd);
+}
+
+// Parse one optional Focus Mode argument, returns 0 if it is not recognized
+int parse_focus_option(const char *arg) {
+    if (strcmp(arg, "--script") == 0) {
+        focus_options.script = true;
+        return 1;
+    }
+    if (strcmp(arg, "--realtime") == 0) {
+        focus_options.realtime = true;
+        return 1;
+    }
+    if (strncmp(arg, "--load=", 7) == 0 && arg[7] != '\0') {
+        focus_options.load_path = arg + 7;
+        return 1;
+    }
+    if (strcmp(arg, "--timed") == 0) {
+        focus_options.timed = true;
+        return 1;
+    }
+    return 0;
+}
+
+// Stop the producers and print what they sent against what reached us in total.
+// Once target is cleared no producer starts another send, and active counts the
+// ones already past that check, so after it drops to 0 and the last signals are
+// drained the counters and the received total are final.
+void close_load_counters() {
+    __atomic_store_n(&load.counters->target, 0, __ATOMIC_SEQ_CST);
+
+    struct timespec pause = { 0, 100000 };
+    int waited_us = 0;
+    while (__atomic_load_n(&load.counters->active, __ATOMIC_SEQ_CST) > 0 &&
+           waited_us < LOAD_STOP_TIMEOUT_MS * 1000) {
+        nanosleep(&pause, NULL);
+        waited_us += 100;
+    }
+    bool stopped = __atomic_load_n(&load.counters->active, __ATOMIC_SEQ_CST) == 0;
+
+    drain_distractions();
+    long sent, rejected;
+    read_load_counters(&sent, &rejected);
+    load.total_received += load.received;
+
+    printf("\nLoad total: sent %ld, received %ld, lost %ld", sent, load.total_received, sent - load.total_received);
+    if (rejected > 0) printf(" (%ld more rejected as queue full)", rejected);
+    printf("\n");
+    if (!stopped) {
+        printf("Warning: a producer did not stop within %d ms, the totals may be incomplete\n", LOAD_STOP_TIMEOUT_MS);
+    }
+
+    munmap(load.counters, sizeof(LoadCounters));
+    free(load.delays);
+}
+
 // Main function to run Focus Mode
 void runFocusMode(int numOfRounds, int roundDuration) {
     sigset_t oldset;
 
+    if (focus_options.timed && roundDuration <= 0) {
+        fprintf(stderr, "Error: a timed round must last at least 1 ms\n");
+        return;
+    }
+
     // Set up signal handlers using sigaction
     setup_signal_handlers_Focus();
 
@@ -176,14 +701,42 @@ void runFocusMode(int numOfRounds, int roundDuration) {
     // Block all distraction signals using sigprocmask
     block_distractions(&oldset);
 
+    // Producers may only start once every distraction is blocked
+    if (focus_options.load_path && !open_load_counters(focus_options.load_path)) {
+        unblock_distractions(&oldset);
+        return;
+    }
+
+    TimedLoop timed = { -1, -1, -1, false };
+    if (focus_options.timed && !open_timed_loop(&timed)) {
+        numOfRounds = 0;
+    }
+
     // Run all rounds
+    sigset_t sent;
     for (int round = 1; round <= numOfRounds; round++) {
-        run_focus_round(round, roundDuration);
+        round_start_us = focus_clock_us();
+        if (focus_options.timed) {
+            sigemptyset(&sent);
+            run_timed_round(round, roundDuration, &timed, &sent);
+        } else if (focus_options.script) {
+            sigemptyset(&sent);
+            run_script_round(round, roundDuration, &sent);
+        } else {
+            run_focus_round(round, roundDuration);
+        }
 
         // Check pending distractions using sigpending and sigismember
         check_pending_distractions();
     }
 
+    close_timed_loop(&timed);
+
+    // Tell the producers to stop before anything is unblocked
+    if (load.counters) {
+        close_load_counters();
+    }
+
     // Unblock all signals at the end using sigprocmask
     unblock_distractions(&oldset);
 
@@ -0,0 +1,143 @@
+// Benchmark harness for the CPU Scheduler engine: times parsing and every
+// scheduling algorithm on one or more traces, with the clock always virtual.
+//
+//   gcc -O2 Scheduler-Bench.c -o scheduler-bench
+//   ./scheduler-bench trace-1k.csv trace-1m.csv --quantum=4
+//
+// Any other argument is a CPU Scheduler engine option (--algorithms=, --cores=,
+// --mlfq-levels=, ...). Reports are not rendered unless --format= is given, in
+// which case they are written to /dev/null so the formatting cost is included.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "CPU-Scheduler.c"
+
+#define MAX_TRACES 64
+
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Peak resident set size of the benchmark so far, in MiB
+double peak_rss_mib(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+void print_row(const char *trace, int rows, const char *stage, double seconds) {
+    double rate = seconds > 0 ? rows / seconds : 0;
+    printf("%-28s %10d  %-20s %10.4f %12.0f %10.1f\n", trace, rows, stage, seconds, rate, peak_rss_mib());
+    fflush(stdout);
+}
+
+void bench_trace(const char *path, int timeQuantum, bool render) {
+    const char *name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+    ProcessTable t;
+    init_process_table(&t);
+
+    double start = now_seconds();
+    int n = read_processes(path, &t);
+    if (n <= 0 || !sort_by_arrival(&t)) {
+        fprintf(stderr, "Error: Could not read processes from %s\n", path);
+        free_process_table(&t);
+        return;
+    }
+    print_row(name, n, "parse", now_seconds() - start);
+
+    // Rendered reports go to /dev/null, our own table stays on the real stdout
+    int saved_stdout = -1;
+    if (render) {
+        int devnull = open("/dev/null", O_WRONLY);
+        saved_stdout = dup(STDOUT_FILENO);
+        if (devnull == -1 || saved_stdout == -1) {
+            fprintf(stderr, "Error: Could not redirect reports to /dev/null\n");
+            exit(1);
+        }
+        dup2(devnull, STDOUT_FILENO);
+        close(devnull);
+    }
+
+    for (int k = 0; k < sched_options.algorithm_count; k++) {
+        Algorithm alg = sched_options.algorithms[k];
+        start = now_seconds();
+        run_algorithm(alg, &t, timeQuantum);
+        double seconds = now_seconds() - start;
+
+        if (render) dup2(saved_stdout, STDOUT_FILENO);
+        print_row(name, n, algorithm_names[alg], seconds);
+        if (render) {
+            int devnull = open("/dev/null", O_WRONLY);
+            dup2(devnull, STDOUT_FILENO);
+            close(devnull);
+        }
+    }
+
+    if (render) {
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+    }
+    free_process_table(&t);
+}
+
+int main(int argc, char *argv[]) {
+    const char *traces[MAX_TRACES];
+    int trace_count = 0;
+    int timeQuantum = 2;
+
+    // Every algorithm by default, rendering nothing
+    for (int alg = 0; alg < ALG_COUNT; alg++) {
+        sched_options.algorithms[alg] = alg;
+    }
+    sched_options.algorithm_count = ALG_COUNT;
+    sched_options.format = FORMAT_NONE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--quantum=", 10) == 0) {
+            if (!parse_positive(argv[i] + 10, &timeQuantum)) {
+                fprintf(stderr, "Error: Invalid time quantum %s\n", argv[i] + 10);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            if (!parse_scheduler_option(argv[i])) {
+                fprintf(stderr, "Error: Unknown option %s\n", argv[i]);
+                return 1;
+            }
+        } else if (trace_count < MAX_TRACES) {
+            traces[trace_count++] = argv[i];
+        }
+    }
+    if (trace_count == 0) {
+        fprintf(stderr, "Usage: %s <trace.csv>... [--quantum=Q] [engine options]\n", argv[0]);
+        return 1;
+    }
+
+    // These replace the timed virtual-clock run with real processes, a stream or a sweep
+    if (sched_options.execute || sched_options.online || sched_options.sweep_count > 0) {
+        fprintf(stderr, "Error: --execute, --online and --sweep cannot be benchmarked\n");
+        fprintf(stderr, "Usage: %s <trace.csv>... [--quantum=Q] [engine options]\n", argv[0]);
+        return 1;
+    }
+
+    // Only the simulation is measured, never the pacing
+    sched_options.clock = CLOCK_VIRTUAL;
+    sched_options.parallel = false;
+    if (sched_options.cores > 0) {
+        for (int k = 0; k < sched_options.algorithm_count; k++) {
+            if (sched_options.algorithms[k] > ALG_ROUND_ROBIN) {
+                fprintf(stderr, "Error: --cores supports only fcfs, sjf, priority and rr\n");
+                return 1;
+            }
+        }
+    }
+
+    printf("%-28s %10s  %-20s %10s %12s %10s\n", "Trace", "Rows", "Stage", "Seconds", "Rows/s", "Peak MiB");
+    for (int k = 0; k < trace_count; k++) {
+        bench_trace(traces[k], timeQuantum, sched_options.format != FORMAT_NONE);
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+// Converts a CSV process trace into the binary trace format, which the CPU
+// Scheduler maps into memory instead of parsing.
+//
+//   gcc -O2 Trace-Convert.c -o trace-convert
+//   ./trace-convert processes.csv processes.trace
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CPU-Scheduler.c"
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <processes.csv> <output.trace>\n", argv[0]);
+        return 1;
+    }
+
+    ProcessTable processes;
+    init_process_table(&processes);
+    int n = read_processes(argv[1], &processes);
+
+    if (n <= 0 || !sort_by_arrival(&processes)) {
+        fprintf(stderr, "Error: Could not read processes from file\n");
+        free_process_table(&processes);
+        return 1;
+    }
+
+    int ok = write_binary_trace(&processes, argv[2]);
+    free_process_table(&processes);
+    return ok ? 0 : 1;
+}
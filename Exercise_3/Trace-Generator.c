@@ -0,0 +1,181 @@
+// Synthetic workload generator for the CPU Scheduler.
+// Writes traces in the name,description,arrival,burst,priority format of CPU-Scheduler-Tests.
+//
+//   gcc Trace-Generator.c -o trace-gen -lm
+//   ./trace-gen 100000 --arrivals=bursty --bursts=heavy-tailed --output=trace.csv
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <limits.h>
+#include <errno.h>
+
+#define MIN_ROWS 10
+#define MAX_ROWS 10000000
+#define MAX_BURST 1000000
+#define PARETO_ALPHA 1.5
+#define BURSTY_MEAN_CLUSTER 8
+
+typedef enum {
+    ARRIVALS_POISSON,   // Exponential gaps between single arrivals
+    ARRIVALS_BURSTY     // Clusters of arrivals at the same instant, exponential gaps between clusters
+} ArrivalModel;
+
+typedef enum {
+    BURSTS_EXPONENTIAL,
+    BURSTS_HEAVY_TAILED // Pareto with the same mean, a few very long jobs
+} BurstModel;
+
+typedef struct {
+    long rows;
+    ArrivalModel arrivals;
+    BurstModel bursts;
+    double rate;        // Mean arrivals per time unit
+    double mean_burst;
+    uint64_t seed;
+    const char *output;
+} GeneratorOptions;
+
+const char *descriptions[] = {
+    "Compile job", "Web request", "Database query", "Backup task", "Video encode",
+    "Log rotation", "Cache refresh", "Report export", "Mail delivery", "Index rebuild"
+};
+
+// xorshift64*: small, fast and identical on every platform, so a seed always gives the same trace
+uint64_t rng_state;
+
+uint64_t next_random(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+// Uniform in (0, 1]
+double next_uniform(void) {
+    return ((next_random() >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+double next_exponential(double mean) {
+    return -mean * log(next_uniform());
+}
+
+int next_burst(const GeneratorOptions *opt) {
+    double burst;
+    if (opt->bursts == BURSTS_HEAVY_TAILED) {
+        double scale = opt->mean_burst * (PARETO_ALPHA - 1) / PARETO_ALPHA;
+        burst = scale / pow(next_uniform(), 1.0 / PARETO_ALPHA);
+    } else {
+        burst = next_exponential(opt->mean_burst);
+    }
+
+    if (burst < 1) return 1;
+    if (burst > MAX_BURST) return MAX_BURST;
+    return (int)ceil(burst);
+}
+
+void print_usage(const char *program) {
+    fprintf(stderr, "Usage: %s <rows> [--arrivals=poisson|bursty] [--bursts=exponential|heavy-tailed]"
+                    " [--rate=R] [--mean-burst=M] [--seed=S] [--output=file.csv]\n", program);
+    exit(1);
+}
+
+int parse_option(const char *arg, GeneratorOptions *opt) {
+    if (strcmp(arg, "--arrivals=poisson") == 0) {
+        opt->arrivals = ARRIVALS_POISSON;
+    } else if (strcmp(arg, "--arrivals=bursty") == 0) {
+        opt->arrivals = ARRIVALS_BURSTY;
+    } else if (strcmp(arg, "--bursts=exponential") == 0) {
+        opt->bursts = BURSTS_EXPONENTIAL;
+    } else if (strcmp(arg, "--bursts=heavy-tailed") == 0) {
+        opt->bursts = BURSTS_HEAVY_TAILED;
+    } else if (strncmp(arg, "--rate=", 7) == 0) {
+        opt->rate = atof(arg + 7);
+        return opt->rate > 0;
+    } else if (strncmp(arg, "--mean-burst=", 13) == 0) {
+        opt->mean_burst = atof(arg + 13);
+        return opt->mean_burst >= 1;
+    } else if (strncmp(arg, "--seed=", 7) == 0) {
+        // Digits only: strtoull() alone would accept "-1", "12abc" or an empty value
+        char *end;
+        errno = 0;
+        opt->seed = strtoull(arg + 7, &end, 10);
+        return arg[7] >= '0' && arg[7] <= '9' && *end == '\0' && errno == 0;
+    } else if (strncmp(arg, "--output=", 9) == 0) {
+        opt->output = arg + 9;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    GeneratorOptions opt = {
+        .arrivals = ARRIVALS_POISSON,
+        .bursts = BURSTS_EXPONENTIAL,
+        .rate = 0.2,
+        .mean_burst = 4,
+        .seed = 1,
+        .output = NULL,
+    };
+
+    if (argc < 2) print_usage(argv[0]);
+    opt.rows = strtol(argv[1], NULL, 10);
+    if (opt.rows < MIN_ROWS || opt.rows > MAX_ROWS) {
+        fprintf(stderr, "Error: rows must be between %d and %d\n", MIN_ROWS, MAX_ROWS);
+        return 1;
+    }
+    for (int i = 2; i < argc; i++) {
+        if (!parse_option(argv[i], &opt)) print_usage(argv[0]);
+    }
+
+    FILE *out = opt.output ? fopen(opt.output, "w") : stdout;
+    if (!out) {
+        perror("Error opening output file");
+        return 1;
+    }
+    static char buffer[1 << 20];
+    setvbuf(out, buffer, _IOFBF, sizeof(buffer));
+
+    // Record how the trace was made, like the comment lines of the sample inputs
+    fprintf(out, "#");
+    for (int i = 0; i < argc; i++) {
+        fprintf(out, " %s", argv[i]);
+    }
+    fprintf(out, "\n");
+
+    // Spread the seed over all 64 bits, small seeds would otherwise start with similar draws
+    rng_state = (opt.seed + 1) * 0x9E3779B97F4A7C15ULL;
+    if (rng_state == 0) rng_state = 1;
+    double clock = 0;
+    int cluster_left = 0;
+    int ndesc = sizeof(descriptions) / sizeof(descriptions[0]);
+
+    for (long i = 0; i < opt.rows; i++) {
+        if (opt.arrivals == ARRIVALS_BURSTY) {
+            // A new cluster starts after a gap long enough to keep the same mean rate
+            if (cluster_left == 0) {
+                if (i > 0) clock += next_exponential(BURSTY_MEAN_CLUSTER / opt.rate);
+                cluster_left = 1 + (int)next_exponential(BURSTY_MEAN_CLUSTER - 1);
+            }
+            cluster_left--;
+        } else if (i > 0) {
+            clock += next_exponential(1 / opt.rate);
+        }
+
+        if (clock > INT_MAX) {
+            fprintf(stderr, "Error: arrival times overflow after %ld rows, raise --rate\n", i);
+            fclose(out);
+            return 1;
+        }
+        fprintf(out, "P%ld,%s,%ld,%d,%d\n", i + 1, descriptions[next_random() % ndesc],
+                (long)clock, next_burst(&opt), (int)(next_random() % 10) + 1);
+    }
+
+    if (fclose(out) != 0) {
+        perror("Error writing output file");
+        return 1;
+    }
+    return 0;
+}
@@ -5,28 +5,44 @@
 #include "Focus-Mode.c"
 #include "CPU-Scheduler.c"
 
+void print_usage(const char *program) {
+    printf("Usage: %s <Focus-Mode/CPU-Schedule> <Num-Of-Rounds/Processes.csv> <Round-Duration/Time-Quantum>",
+           program);
+    exit(0);
+}
+
 int main(int argc, char *argv[]) {
-    if (argc != 4) {
-        printf("Usage: %s <Focus-Mode/CPU-Schedule> <Num-Of-Rounds/Processes.csv> <Round-Duration/Time-Quantum>",
-               argv[0]);
-        exit(0);
+    if (argc < 4) {
+        print_usage(argv[0]);
     }
 
     if (strcmp(argv[1], "Focus-Mode") && strcmp(argv[1], "CPU-Scheduler")) {
-        printf("Usage: %s <Focus-Mode/CPU-Schedule> <Num-Of-Rounds/Processes.csv> <Round-Duration/Time-Quantum>",
-               argv[0]);
-        exit(0);
+        print_usage(argv[0]);
     }
 
     if (strcmp(argv[1], "Focus-Mode") == 0) {
         int numOfRounds = atoi(argv[2]);
         int roundDuration = atoi(argv[3]);
+
+        // Anything after the three required arguments is an optional Focus Mode setting
+        for (int i = 4; i < argc; i++) {
+            if (!parse_focus_option(argv[i])) {
+                print_usage(argv[0]);
+            }
+        }
         runFocusMode(numOfRounds, roundDuration);
     }
 
     if (strcmp(argv[1], "CPU-Scheduler") == 0) {
         char *processesCsvFilePath = argv[2];
         int timeQuantum = atoi(argv[3]);
+
+        // Anything after the three required arguments is an optional engine setting
+        for (int i = 4; i < argc; i++) {
+            if (!parse_scheduler_option(argv[i])) {
+                print_usage(argv[0]);
+            }
+        }
         runCPUScheduler(processesCsvFilePath, timeQuantum);
     }
 }
\ No newline at end of file